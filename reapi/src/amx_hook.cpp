@@ -1,12 +1,127 @@
 #include "precompiled.h"
 
+// AMX Mod X has no module api for the status of plugin (paused, stopped by set_fail_state).
+// In the plugin object of AMX Mod X 1.9 and 1.10 it's a field followed by the link to the next plugin and the plugin id,
+// the offset is looked up in the loaded plugins. The layout isn't a stable api, so the direct calls are off
+// unless enabled by the cvar reapi_direct_calls, otherwise and until the offset is found the handlers go through ExecuteForward.
+cvar_t g_cvarDirectCalls = { const_cast<char *>("reapi_direct_calls"), const_cast<char *>("0"), 0, 0.0f, nullptr };
+
+static int g_pluginStatusOffset = -1;
+static bool g_pluginStatusProbed = false;
+
+static bool IsKnownPluginLayout()
+{
+	static int known = -1;
+	if (known != -1)
+		return known == 1;
+
+	int major = 0, minor = 0;
+	const char *version = CVAR_GET_STRING("amxmodx_version");
+
+	known = (version && sscanf(version, "%d.%d", &major, &minor) == 2 && major == 1 && (minor == 9 || minor == 10)) ? 1 : 0;
+
+	if (!known)
+		AMXX_Log("AMX Mod X version \"%s\" isn't supported for the direct calls, the hookchain handlers go through ExecuteForward", version ? version : "");
+
+	return known == 1;
+}
+
+void FindPluginStatusField()
+{
+	static bool warned = false;
+
+	g_pluginStatusProbed = true;
+
+	if (g_pluginStatusOffset != -1 || !IsKnownPluginLayout())
+		return;
+
+	const size_t maxOffset = 128;
+	for (size_t offset = sizeof(AMX); offset < sizeof(AMX) + maxOffset; offset += sizeof(int))
+	{
+		size_t matched = 0, running = 0;
+
+		AMX *amx = g_amxxapi.GetAmxScript(0);
+		for (int id = 0; amx; id++)
+		{
+			// the last plugin has no link
+			AMX *next = g_amxxapi.GetAmxScript(id + 1);
+
+			auto plugin = (const uint8 *)amx->userdata[AMX_USERDATA_PLUGIN];
+			auto nextPlugin = next ? next->userdata[AMX_USERDATA_PLUGIN] : nullptr;
+
+			if (plugin && (nextPlugin || !next))
+			{
+				int status    = *(const int *)(plugin + offset);
+				void *link    = *(void * const *)(plugin + offset + sizeof(int));
+				int pluginId  = *(const int *)(plugin + offset + sizeof(int) + sizeof(void *));
+
+				if (link != nextPlugin || pluginId != id || status < 0 || status > AMX_PLUGIN_RUNNING) {
+					matched = 0;
+					break;
+				}
+
+				matched++;
+				if (status == AMX_PLUGIN_RUNNING)
+					running++;
+			}
+
+			amx = next;
+		}
+
+		if (matched && running) {
+			g_pluginStatusOffset = offset;
+			return;
+		}
+	}
+
+	if (!warned) {
+		AMXX_Log("The status of the plugins isn't found, the hookchain handlers go through ExecuteForward until it is");
+		warned = true;
+	}
+}
+
+void ResetPluginStatusProbe()
+{
+	if (g_pluginStatusOffset == -1)
+		g_pluginStatusProbed = false;
+}
+
+bool IsPluginRunning(AMX *amx)
+{
+	if (likely(g_cvarDirectCalls.value == 0.0f))
+		return false;
+
+	// probed once after the handlers are registered, the cvar can be enabled at any time
+	if (unlikely(g_pluginStatusOffset == -1))
+	{
+		if (g_pluginStatusProbed)
+			return false;
+
+		FindPluginStatusField();
+		if (g_pluginStatusOffset == -1)
+			return false;
+	}
+
+	auto plugin = (const uint8 *)amx->userdata[AMX_USERDATA_PLUGIN];
+	return plugin && *(const int *)(plugin + g_pluginStatusOffset) == AMX_PLUGIN_RUNNING;
+}
+
 CAmxxHookBase::CAmxxHookBase(AMX *amx, const char *funcname, int forwardIndex, int index) :
 	m_fwdindex(forwardIndex),
+	m_funcindex(-1),
 	m_index(index),
 	m_state(FSTATE_ENABLED),
+	m_mode(FMODE_INPLACE),
 	m_amx(amx)
 {
 	Q_strlcpy(m_CallbackName, funcname);
+
+	// public function index for direct calls through amx_Exec
+	if (g_amxxapi.amx_FindPublic(amx, funcname, &m_funcindex) != AMX_ERR_NONE)
+		m_funcindex = -1;
+
+	// a new plugin could be loaded since the last probe
+	ResetPluginStatusProbe();
 }
 
 CAmxxHookBase::~CAmxxHookBase()
@@ -1,5 +1,12 @@
 #pragma once
 
+// AMX Mod X keeps the debugger of plugin in the userdata slot 2 and the plugin itself in the slot 3 (see AMX structure)
+#define AMX_USERDATA_DEBUGGER 2
+#define AMX_USERDATA_PLUGIN   3
+
+// status of running plugin in AMX Mod X (ps_running)
+#define AMX_PLUGIN_RUNNING 5
+
 enum fwdstate
 {
 	FSTATE_INVALID = 0,
@@ -8,6 +15,19 @@ enum fwdstate
 	FSTATE_STOPPED
 };
 
+enum fwdmode
+{
+	FMODE_INPLACE = 0,	// called within the hookchain
+	FMODE_DEFERRED,		// post handler called at the start of next frame
+	FMODE_BATCH			// called once per frame with all the players of frame
+};
+
+extern cvar_t g_cvarDirectCalls;
+
+void FindPluginStatusField();
+void ResetPluginStatusProbe();
+bool IsPluginRunning(AMX *amx);
+
 class CAmxxHookBase
 {
 public:
@@ -15,17 +35,27 @@ public:
 	CAmxxHookBase(AMX *amx, const char *funcname, int forwardIndex, int index);
 
 	int GetFwdIndex()             const { return m_fwdindex; }
+	int GetFuncIndex()            const { return m_funcindex; }
 	int GetIndex()                const { return m_index; }
 	fwdstate GetState()           const { return m_state; }
 	AMX *GetAmx()                 const { return m_amx; }
 	const char *GetCallbackName() const { return m_CallbackName; }
+	fwdmode GetMode()             const { return m_mode; }
+
+	// the debugger of AMX Mod X has to see every call of plugin, so those are called through ExecuteForward,
+	// as well as the calls of paused or failed plugins, ExecuteForward skips them,
+	// the status of plugin is known only with reapi_direct_calls enabled
+	bool CanExecDirect() const { return m_funcindex >= 0 && m_amx->userdata[AMX_USERDATA_DEBUGGER] == nullptr && IsPluginRunning(m_amx); }
+
+	void SetMode(fwdmode mode) { m_mode = mode; }
 
 	void SetState(fwdstate st) { m_state = st; }
 	void Error(int error, const char *fmt, ...);
 
 private:
-	int m_fwdindex, m_index;
+	int m_fwdindex, m_funcindex, m_index;
 	char m_CallbackName[64];
 	fwdstate m_state;
+	fwdmode m_mode;
 	AMX *m_amx;
 };
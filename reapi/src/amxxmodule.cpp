@@ -46,7 +46,7 @@ static struct funcreq_t
 	//DECLARE_REQ(PrintSrvConsole),
 	//DECLARE_REQ(GetModname),
 	DECLARE_REQ(GetAmxScriptName),
-	//DECLARE_REQ(GetAmxScript),
+	DECLARE_REQ(GetAmxScript),
 	DECLARE_REQ(FindAmxScriptByAmx),
 	//DECLARE_REQ(FindAmxScriptByName),
 	DECLARE_REQ(SetAmxString),
@@ -86,9 +86,9 @@ static struct funcreq_t
 	//DECLARE_REQ(IsPlayerHLTV),
 	//DECLARE_REQ(GetPlayerArmor),
 	//DECLARE_REQ(GetPlayerHealth),
-	//DECLARE_REQ(amx_Exec),
+	DECLARE_REQ(amx_Exec),
 	//DECLARE_REQ(amx_Execv),
-	//DECLARE_REQ(amx_Allot),
+	DECLARE_REQ(amx_Allot),
 	DECLARE_REQ(amx_FindPublic),
 	//DECLARE_REQ(LoadAmxScript),
 	//DECLARE_REQ(UnloadAmxScript),
@@ -104,7 +104,7 @@ static struct funcreq_t
 	//DECLARE_REQ(Format),
 	//DECLARE_REQ(RegisterFunction),
 	//DECLARE_REQ(RequestFunction),
-	//DECLARE_REQ(amx_Push),
+	DECLARE_REQ(amx_Push),
 	DECLARE_REQ(SetPlayerTeamInfo),
 	//DECLARE_REQ(PlayerPropAddr),
 	//DECLARE_REQ(RegAuthFunc),
@@ -169,6 +169,7 @@ C_DLLEXPORT int AMXX_Attach(PFN_REQ_FNPTR reqFnptrFunc)
 	RegisterNatives_Rechecker();
 	RegisterNatives_Reunion();
 	RegisterNatives_Common();
+	RegisterNatives_Async();
 
 	return AMXX_OK;
 }
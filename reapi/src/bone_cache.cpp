@@ -0,0 +1,469 @@
+#include "precompiled.h"
+
+CBoneCache g_boneCache;
+
+// studio math of HLSDK, the angles are in degrees
+static void AngleMatrix(const Vector &angles, float matrix[3][4])
+{
+	float angle = angles.y * (M_PI * 2 / 360);
+	float sy = sin(angle), cy = cos(angle);
+
+	angle = angles.x * (M_PI * 2 / 360);
+	float sp = sin(angle), cp = cos(angle);
+
+	angle = angles.z * (M_PI * 2 / 360);
+	float sr = sin(angle), cr = cos(angle);
+
+	matrix[0][0] = cp * cy;
+	matrix[1][0] = cp * sy;
+	matrix[2][0] = -sp;
+	matrix[0][1] = sr * sp * cy + cr * -sy;
+	matrix[1][1] = sr * sp * sy + cr * cy;
+	matrix[2][1] = sr * cp;
+	matrix[0][2] = cr * sp * cy + -sr * -sy;
+	matrix[1][2] = cr * sp * sy + -sr * cy;
+	matrix[2][2] = cr * cp;
+	matrix[0][3] = 0.0f;
+	matrix[1][3] = 0.0f;
+	matrix[2][3] = 0.0f;
+}
+
+// the angles are in radians
+static void AngleQuaternion(const float *angles, float q[4])
+{
+	float angle = angles[2] * 0.5f;
+	float sy = sin(angle), cy = cos(angle);
+
+	angle = angles[1] * 0.5f;
+	float sp = sin(angle), cp = cos(angle);
+
+	angle = angles[0] * 0.5f;
+	float sr = sin(angle), cr = cos(angle);
+
+	q[0] = sr * cp * cy - cr * sp * sy;
+	q[1] = cr * sp * cy + sr * cp * sy;
+	q[2] = cr * cp * sy - sr * sp * cy;
+	q[3] = cr * cp * cy + sr * sp * sy;
+}
+
+static void QuaternionSlerp(const float p[4], const float q[4], float t, float qt[4])
+{
+	float qs[4];
+
+	// decide if one of the quaternions is backwards
+	float a = 0, b = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		a += (p[i] - q[i]) * (p[i] - q[i]);
+		b += (p[i] + q[i]) * (p[i] + q[i]);
+	}
+
+	for (int i = 0; i < 4; i++)
+		qs[i] = (a > b) ? -q[i] : q[i];
+
+	float cosom = p[0] * qs[0] + p[1] * qs[1] + p[2] * qs[2] + p[3] * qs[3];
+	float sclp, sclq;
+
+	if ((1.0f + cosom) > 0.000001f)
+	{
+		if ((1.0f - cosom) > 0.000001f)
+		{
+			float omega = acos(cosom);
+			float sinom = sin(omega);
+			sclp = sin((1.0f - t) * omega) / sinom;
+			sclq = sin(t * omega) / sinom;
+		}
+		else
+		{
+			sclp = 1.0f - t;
+			sclq = t;
+		}
+
+		for (int i = 0; i < 4; i++)
+			qt[i] = sclp * p[i] + sclq * qs[i];
+	}
+	else
+	{
+		qt[0] = -qs[1];
+		qt[1] = qs[0];
+		qt[2] = -qs[3];
+		qt[3] = qs[2];
+
+		sclp = sin((1.0f - t) * (0.5f * M_PI));
+		sclq = sin(t * (0.5f * M_PI));
+
+		for (int i = 0; i < 3; i++)
+			qt[i] = sclp * p[i] + sclq * qt[i];
+	}
+}
+
+static void QuaternionMatrix(const float q[4], float matrix[3][4])
+{
+	matrix[0][0] = 1.0f - 2.0f * q[1] * q[1] - 2.0f * q[2] * q[2];
+	matrix[1][0] = 2.0f * q[0] * q[1] + 2.0f * q[3] * q[2];
+	matrix[2][0] = 2.0f * q[0] * q[2] - 2.0f * q[3] * q[1];
+
+	matrix[0][1] = 2.0f * q[0] * q[1] - 2.0f * q[3] * q[2];
+	matrix[1][1] = 1.0f - 2.0f * q[0] * q[0] - 2.0f * q[2] * q[2];
+	matrix[2][1] = 2.0f * q[1] * q[2] + 2.0f * q[3] * q[0];
+
+	matrix[0][2] = 2.0f * q[0] * q[2] + 2.0f * q[3] * q[1];
+	matrix[1][2] = 2.0f * q[1] * q[2] - 2.0f * q[3] * q[0];
+	matrix[2][2] = 1.0f - 2.0f * q[0] * q[0] - 2.0f * q[1] * q[1];
+}
+
+static void ConcatTransforms(const float in1[3][4], const float in2[3][4], float out[3][4])
+{
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 4; j++)
+			out[i][j] = in1[i][0] * in2[0][j] + in1[i][1] * in2[1][j] + in1[i][2] * in2[2][j];
+
+		out[i][3] += in1[i][3];
+	}
+}
+
+// the controllers aren't interpolated on the server, the mouth is closed
+static void StudioCalcBoneAdj(const studiohdr_t *pstudiohdr, const byte *pcontroller, float *adj)
+{
+	auto pbonecontroller = (mstudiobonecontroller_t *)((byte *)pstudiohdr + pstudiohdr->bonecontrollerindex);
+
+	for (int j = 0; j < pstudiohdr->numbonecontrollers && j < MAXSTUDIOCONTROLLERS; j++)
+	{
+		int i = pbonecontroller[j].index;
+		float value;
+
+		if (i > 3) {
+			value = pbonecontroller[j].start;
+		}
+		else if (pbonecontroller[j].type & STUDIO_RLOOP) {
+			value = pcontroller[i] * (360.0f / 256.0f) + pbonecontroller[j].start;
+		}
+		else
+		{
+			value = clamp(pcontroller[i] / 255.0f, 0.0f, 1.0f);
+			value = (1.0f - value) * pbonecontroller[j].start + value * pbonecontroller[j].end;
+		}
+
+		switch (pbonecontroller[j].type & STUDIO_TYPES)
+		{
+		case STUDIO_XR:
+		case STUDIO_YR:
+		case STUDIO_ZR:
+			adj[j] = value * (M_PI / 180.0);
+			break;
+		case STUDIO_X:
+		case STUDIO_Y:
+		case STUDIO_Z:
+			adj[j] = value;
+			break;
+		}
+	}
+}
+
+// walks the run length encoded values up to the frame
+static const mstudioanimvalue_t *StudioAnimValue(const mstudioanim_t *panim, int offset, int &frame)
+{
+	auto panimvalue = (mstudioanimvalue_t *)((byte *)panim + panim->offset[offset]);
+
+	if (panimvalue->num.total < panimvalue->num.valid)
+		frame = 0;
+
+	while (panimvalue->num.total <= frame)
+	{
+		frame -= panimvalue->num.total;
+		panimvalue += panimvalue->num.valid + 1;
+
+		if (panimvalue->num.total < panimvalue->num.valid)
+			frame = 0;
+	}
+
+	return panimvalue;
+}
+
+static void StudioCalcBoneQuaternion(int frame, float s, const mstudiobone_t *pbone, const mstudioanim_t *panim, const float *adj, float q[4])
+{
+	float angle1[3], angle2[3];
+
+	for (int j = 0; j < 3; j++)
+	{
+		if (panim->offset[j + 3] == 0) {
+			angle2[j] = angle1[j] = pbone->value[j + 3]; // default
+		}
+		else
+		{
+			int k = frame;
+			auto panimvalue = StudioAnimValue(panim, j + 3, k);
+
+			if (panimvalue->num.valid > k)
+			{
+				angle1[j] = panimvalue[k + 1].value;
+
+				if (panimvalue->num.valid > k + 1)
+					angle2[j] = panimvalue[k + 2].value;
+				else if (panimvalue->num.total > k + 1)
+					angle2[j] = angle1[j];
+				else
+					angle2[j] = panimvalue[panimvalue->num.valid + 2].value;
+			}
+			else
+			{
+				angle1[j] = panimvalue[panimvalue->num.valid].value;
+
+				if (panimvalue->num.total > k + 1)
+					angle2[j] = angle1[j];
+				else
+					angle2[j] = panimvalue[panimvalue->num.valid + 2].value;
+			}
+
+			angle1[j] = pbone->value[j + 3] + angle1[j] * pbone->scale[j + 3];
+			angle2[j] = pbone->value[j + 3] + angle2[j] * pbone->scale[j + 3];
+		}
+
+		if (pbone->bonecontroller[j + 3] != -1)
+		{
+			angle1[j] += adj[pbone->bonecontroller[j + 3]];
+			angle2[j] += adj[pbone->bonecontroller[j + 3]];
+		}
+	}
+
+	if (angle1[0] != angle2[0] || angle1[1] != angle2[1] || angle1[2] != angle2[2])
+	{
+		float q1[4], q2[4];
+		AngleQuaternion(angle1, q1);
+		AngleQuaternion(angle2, q2);
+		QuaternionSlerp(q1, q2, s, q);
+	}
+	else
+	{
+		AngleQuaternion(angle1, q);
+	}
+}
+
+static void StudioCalcBonePosition(int frame, float s, const mstudiobone_t *pbone, const mstudioanim_t *panim, const float *adj, float pos[3])
+{
+	for (int j = 0; j < 3; j++)
+	{
+		pos[j] = pbone->value[j]; // default
+
+		if (panim->offset[j] != 0)
+		{
+			int k = frame;
+			auto panimvalue = StudioAnimValue(panim, j, k);
+
+			if (panimvalue->num.valid > k)
+			{
+				if (panimvalue->num.valid > k + 1)
+					pos[j] += (panimvalue[k + 1].value * (1.0f - s) + s * panimvalue[k + 2].value) * pbone->scale[j];
+				else
+					pos[j] += panimvalue[k + 1].value * pbone->scale[j];
+			}
+			else
+			{
+				if (panimvalue->num.total <= k + 1)
+					pos[j] += (panimvalue[panimvalue->num.valid].value * (1.0f - s) + s * panimvalue[panimvalue->num.valid + 2].value) * pbone->scale[j];
+				else
+					pos[j] += panimvalue[panimvalue->num.valid].value * pbone->scale[j];
+			}
+		}
+
+		if (pbone->bonecontroller[j] != -1)
+			pos[j] += adj[pbone->bonecontroller[j]];
+	}
+}
+
+static void StudioCalcRotations(const studiohdr_t *pstudiohdr, const mstudioanim_t *panim, const float *adj, int frame, float s, float pos[][3], float q[][4])
+{
+	auto pbones = (mstudiobone_t *)((byte *)pstudiohdr + pstudiohdr->boneindex);
+
+	for (int i = 0; i < pstudiohdr->numbones; i++)
+	{
+		StudioCalcBoneQuaternion(frame, s, &pbones[i], &panim[i], adj, q[i]);
+		StudioCalcBonePosition(frame, s, &pbones[i], &panim[i], adj, pos[i]);
+	}
+}
+
+static void StudioSlerpBones(int numbones, float q1[][4], float pos1[][3], const float q2[][4], const float pos2[][3], float s)
+{
+	s = clamp(s, 0.0f, 1.0f);
+	float s1 = 1.0f - s;
+
+	for (int i = 0; i < numbones; i++)
+	{
+		float q3[4];
+		QuaternionSlerp(q1[i], q2[i], s, q3);
+
+		for (int j = 0; j < 4; j++)
+			q1[i][j] = q3[j];
+
+		for (int j = 0; j < 3; j++)
+			pos1[i][j] = pos1[i][j] * s1 + pos2[i][j] * s;
+	}
+}
+
+// SV_StudioSetupBones of HLSDK for all bones
+static bool StudioSetupBones(const studiohdr_t *pstudiohdr, const edict_t *pEdict, CBoneCache::bonematrix_t *transforms)
+{
+	static float pos[MAXSTUDIOBONES][3], q[MAXSTUDIOBONES][4];
+	static float pos2[MAXSTUDIOBONES][3], q2[MAXSTUDIOBONES][4];
+
+	if (pstudiohdr->numbones <= 0 || pstudiohdr->numbones > MAXSTUDIOBONES)
+		return false;
+
+	int sequence = int(pEdict->v.sequence);
+	if (sequence < 0 || sequence >= pstudiohdr->numseq)
+		sequence = 0;
+
+	auto pseqdesc = (mstudioseqdesc_t *)((byte *)pstudiohdr + pstudiohdr->seqindex) + sequence;
+
+	// the sequence groups in the other files aren't loaded by the module
+	if (pseqdesc->seqgroup != 0)
+		return false;
+
+	auto pseqgroup = (mstudioseqgroup_t *)((byte *)pstudiohdr + pstudiohdr->seqgroupindex);
+	auto panim = (mstudioanim_t *)((byte *)pstudiohdr + pseqgroup->unused2 + pseqdesc->animindex);
+
+	float f = (pseqdesc->numframes > 1) ? (pseqdesc->numframes - 1) * pEdict->v.frame / 256.0f : 0.0f;
+	int frame = int(f);
+	f -= frame;
+
+	float adj[MAXSTUDIOCONTROLLERS] = {};
+	StudioCalcBoneAdj(pstudiohdr, pEdict->v.controller, adj);
+	StudioCalcRotations(pstudiohdr, panim, adj, frame, f, pos, q);
+
+	if (pseqdesc->numblends > 1)
+	{
+		StudioCalcRotations(pstudiohdr, panim + pstudiohdr->numbones, adj, frame, f, pos2, q2);
+		StudioSlerpBones(pstudiohdr->numbones, q, pos, q2, pos2, pEdict->v.blending[0] / 255.0f);
+	}
+
+	// the pitch of the studio models is inverted
+	float rotation[3][4];
+	AngleMatrix(Vector(-pEdict->v.angles.x, pEdict->v.angles.y, pEdict->v.angles.z), rotation);
+
+	for (int k = 0; k < 3; k++)
+		rotation[k][3] = pEdict->v.origin[k];
+
+	auto pbones = (mstudiobone_t *)((byte *)pstudiohdr + pstudiohdr->boneindex);
+
+	// the parent bones go first
+	for (int i = 0; i < pstudiohdr->numbones; i++)
+	{
+		float bonematrix[3][4];
+		QuaternionMatrix(q[i], bonematrix);
+
+		for (int k = 0; k < 3; k++)
+			bonematrix[k][3] = pos[i][k];
+
+		if (pbones[i].parent < 0 || pbones[i].parent >= i)
+			ConcatTransforms(rotation, bonematrix, transforms[i].m);
+		else
+			ConcatTransforms(transforms[pbones[i].parent].m, bonematrix, transforms[i].m);
+	}
+
+	return true;
+}
+
+CBoneCache::entry_t *CBoneCache::Validate(edict_t *pEdict, const studiohdr_t *pstudiohdr)
+{
+	if (m_entries.size() < size_t(gpGlobals->maxEntities + 1))
+		m_entries.resize(gpGlobals->maxEntities + 1, { -1.0f });
+
+	key_t key;
+	Q_memset(&key, 0, sizeof(key));
+	key.pstudiohdr = pstudiohdr;
+	key.sequence = pEdict->v.sequence;
+	key.gaitsequence = pEdict->v.gaitsequence;
+	key.frame = pEdict->v.frame;
+	key.origin = pEdict->v.origin;
+	key.angles = pEdict->v.angles;
+	Q_memcpy(key.controller, pEdict->v.controller, sizeof(key.controller));
+	Q_memcpy(key.blending, pEdict->v.blending, sizeof(key.blending));
+
+	auto &entry = m_entries[indexOfEdict(pEdict)];
+	if (entry.time != gpGlobals->time || Q_memcmp(&entry.key, &key, sizeof(key)) != 0)
+	{
+		entry.time = gpGlobals->time;
+		Q_memcpy(&entry.key, &key, sizeof(key));
+		entry.skeleton = SKELETON_UNKNOWN;
+		entry.bones.assign(pstudiohdr->numbones, { Vector(0, 0, 0), Vector(0, 0, 0), false });
+		entry.attachments.assign(pstudiohdr->numattachments, { Vector(0, 0, 0), Vector(0, 0, 0), false });
+	}
+
+	return &entry;
+}
+
+bool CBoneCache::CompareWithEngine(edict_t *pEdict, const studiohdr_t *pstudiohdr, const entry_t &entry) const
+{
+	const float tolerance = 0.1f;
+
+	for (int bone = 0; bone < pstudiohdr->numbones; bone++)
+	{
+		Vector vecOrigin, vecAngles;
+
+		pEdict->v.angles.x = -pEdict->v.angles.x;
+		GET_BONE_POSITION(pEdict, bone, vecOrigin, vecAngles);
+		pEdict->v.angles.x = -pEdict->v.angles.x;
+
+		for (int k = 0; k < 3; k++)
+		{
+			if (fabs(vecOrigin[k] - entry.transforms[bone].m[k][3]) > tolerance)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+bool CBoneCache::Setup(edict_t *pEdict, const studiohdr_t *pstudiohdr, entry_t &entry)
+{
+	// the game could set up the bones of the sequence differently, e.g. the gait of players
+	check_t &check = m_checks[{ pstudiohdr, entry.key.sequence, entry.key.gaitsequence }];
+	if (check.failed)
+		return false;
+
+	entry.transforms.resize(pstudiohdr->numbones);
+
+	if (!StudioSetupBones(pstudiohdr, pEdict, entry.transforms.data())) {
+		check.failed = true;
+		return false;
+	}
+
+	if (check.passed < VERIFY_PASSES)
+	{
+		if (!CompareWithEngine(pEdict, pstudiohdr, entry)) {
+			check.failed = true;
+			return false;
+		}
+
+		check.passed++;
+	}
+
+	return true;
+}
+
+const CBoneCache::bonematrix_t *CBoneCache::GetSkeleton(edict_t *pEdict, const studiohdr_t *pstudiohdr)
+{
+	entry_t *entry = Validate(pEdict, pstudiohdr);
+	if (entry->skeleton == SKELETON_UNKNOWN)
+		entry->skeleton = Setup(pEdict, pstudiohdr, *entry) ? SKELETON_READY : SKELETON_ENGINE;
+
+	return (entry->skeleton == SKELETON_READY) ? entry->transforms.data() : nullptr;
+}
+
+CBoneCache::position_t *CBoneCache::GetBone(edict_t *pEdict, const studiohdr_t *pstudiohdr, int bone)
+{
+	return &Validate(pEdict, pstudiohdr)->bones[bone];
+}
+
+CBoneCache::position_t *CBoneCache::GetAttachment(edict_t *pEdict, const studiohdr_t *pstudiohdr, int attachment)
+{
+	return &Validate(pEdict, pstudiohdr)->attachments[attachment];
+}
+
+void CBoneCache::Clear()
+{
+	// the models are loaded again on the next map
+	m_entries.clear();
+	m_checks.clear();
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+// Skeletons of the entities set up during the frame.
+// The engine sets up the bone transforms on each query, the whole skeleton is set up once
+// per entity instead and kept until the frame or the animation state of the entity
+// (model, sequence, frame, origin, angles, controllers, blending) changes.
+// The bones are set up by the studio code of HLSDK, the first skeletons of each model and
+// sequence are compared with the engine. If the game sets them up differently, the positions
+// are got from the engine one by one and kept the same way.
+class CBoneCache
+{
+public:
+	struct bonematrix_t
+	{
+		float m[3][4];
+	};
+
+	struct position_t
+	{
+		Vector origin;
+		Vector angles;
+		bool valid;
+	};
+
+	// the bone transforms by bone index, nullptr if the skeleton of the model can't be set up
+	const bonematrix_t *GetSkeleton(edict_t *pEdict, const studiohdr_t *pstudiohdr);
+
+	// positions got from the engine if there is no skeleton
+	position_t *GetBone(edict_t *pEdict, const studiohdr_t *pstudiohdr, int bone);
+	position_t *GetAttachment(edict_t *pEdict, const studiohdr_t *pstudiohdr, int attachment);
+	void Clear();
+
+private:
+	static const int VERIFY_PASSES = 4;     // skeletons compared with the engine for each sequence
+
+	enum skeleton_e
+	{
+		SKELETON_UNKNOWN,
+		SKELETON_READY,
+		SKELETON_ENGINE,
+	};
+
+	struct key_t
+	{
+		const studiohdr_t *pstudiohdr;
+		int sequence;
+		int gaitsequence;
+		float frame;
+		Vector origin;
+		Vector angles;
+		byte controller[4];
+		byte blending[2];
+	};
+
+	struct entry_t
+	{
+		float time;
+		key_t key;
+		skeleton_e skeleton;
+		std::vector<bonematrix_t> transforms;
+		std::vector<position_t> bones;
+		std::vector<position_t> attachments;
+	};
+
+	struct check_key_t
+	{
+		const studiohdr_t *pstudiohdr;
+		int sequence;
+		int gaitsequence;
+
+		bool operator==(const check_key_t &other) const { return pstudiohdr == other.pstudiohdr && sequence == other.sequence && gaitsequence == other.gaitsequence; }
+	};
+
+	struct check_hash_t
+	{
+		size_t operator()(const check_key_t &key) const { return size_t(key.pstudiohdr) ^ (size_t(key.sequence) << 16) ^ size_t(key.gaitsequence); }
+	};
+
+	struct check_t
+	{
+		int passed;
+		bool failed;
+	};
+
+	entry_t *Validate(edict_t *pEdict, const studiohdr_t *pstudiohdr);
+	bool Setup(edict_t *pEdict, const studiohdr_t *pstudiohdr, entry_t &entry);
+	bool CompareWithEngine(edict_t *pEdict, const studiohdr_t *pstudiohdr, const entry_t &entry) const;
+
+	std::vector<entry_t> m_entries;     // by entity index
+	std::unordered_map<check_key_t, check_t, check_hash_t> m_checks;   // by model, sequence and gait sequence
+};
+
+extern CBoneCache g_boneCache;
@@ -28,7 +28,7 @@ DLL_FUNCTIONS gFunctionTable =
 	NULL,					// pfnServerDeactivate
 	NULL,					// pfnPlayerPreThink
 	NULL,					// pfnPlayerPostThink
-	NULL,					// pfnStartFrame
+	&StartFrame,			// pfnStartFrame
 	NULL,					// pfnParmsNewLevel
 	NULL,					// pfnParmsChangeLevel
 	NULL,					// pfnGetGameDescription
@@ -73,9 +73,9 @@ DLL_FUNCTIONS gFunctionTable_Post =
 	NULL,					// pfnRestoreGlobalState
 	NULL,					// pfnResetGlobalState
 	NULL,					// pfnClientConnect
-	NULL,					// pfnClientDisconnect
+	&ClientDisconnect_Post,	// pfnClientDisconnect
 	NULL,					// pfnClientKill
-	NULL,					// pfnClientPutInServer
+	&ClientPutInServer_Post,	// pfnClientPutInServer
 	NULL,					// pfnClientCommand
 	NULL,					// pfnClientUserInfoChanged
 	&ServerActivate_Post,	// pfnServerActivate
@@ -0,0 +1,61 @@
+#include "precompiled.h"
+
+CEntityInitCache g_entityInitCache;
+
+void CEntityInitCache::Init()
+{
+	if (m_hook || !api_cfg.hasReHLDS())
+		return;
+
+	m_hook = g_hookManager.getHook(RH_GetEntityInit);
+	m_hook->acquire();
+}
+
+void CEntityInitCache::Shutdown()
+{
+	if (m_hook) {
+		m_hook->release();
+		m_hook = nullptr;
+	}
+
+	Clear();
+	ClearRemaps();
+}
+
+void CEntityInitCache::Clear()
+{
+	m_cache.clear();
+	m_cacheNames.clear();
+}
+
+const char *CEntityInitCache::AddName(std::deque<std::string> &names, const char *classname)
+{
+	// the strings don't move when the deque grows at the end
+	names.emplace_back(classname);
+	return names.back().c_str();
+}
+
+void CEntityInitCache::SetRemap(const char *classname, const char *target)
+{
+	auto remap = m_remaps.find(classname);
+
+	// the cache is keyed by the remapped classname, it stays valid
+	if (target[0] == '\0') {
+		// the name is kept until the remaps are cleared
+		if (remap != m_remaps.end())
+			m_remaps.erase(remap);
+
+		return;
+	}
+
+	if (remap != m_remaps.end())
+		remap->second = target;
+	else
+		m_remaps.emplace(AddName(m_remapNames, classname), target);
+}
+
+void CEntityInitCache::ClearRemaps()
+{
+	m_remaps.clear();
+	m_remapNames.clear();
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+// Cache of the entity factories resolved by GetEntityInit and the classname remap rules.
+// The rules are applied before the hooks of the plugins; the result of the hookchain
+// is cached only while no plugin hooks GetEntityInit, those may decide per call.
+class CEntityInitCache
+{
+public:
+	void Init();
+	void Shutdown();
+	void Clear();   // on map change, the rules are kept
+
+	void SetRemap(const char *classname, const char *target);
+	void ClearRemaps();
+
+	// called by the hook wrapper
+	template <typename original_t>
+	ENTITYINIT Resolve(char *classname, original_t original);
+
+private:
+	// the classnames are looked up without a copy, case sensitive as the factories of gamedll
+	struct hash_t
+	{
+		size_t operator()(const char *str) const
+		{
+			// FNV-1a
+			uint32 hash = 2166136261u;
+			for (; *str; str++)
+			{
+				hash ^= (uint8)*str;
+				hash *= 16777619u;
+			}
+
+			return hash;
+		}
+	};
+
+	struct equal_t
+	{
+		bool operator()(const char *a, const char *b) const { return !Q_strcmp(a, b); }
+	};
+
+	// keeps the key of the table, the classname passed to the hook doesn't live long
+	static const char *AddName(std::deque<std::string> &names, const char *classname);
+
+	std::unordered_map<const char *, ENTITYINIT, hash_t, equal_t> m_cache;
+	std::unordered_map<const char *, std::string, hash_t, equal_t> m_remaps;
+	std::deque<std::string> m_cacheNames;
+	std::deque<std::string> m_remapNames;
+	hook_t *m_hook = nullptr;
+};
+
+extern CEntityInitCache g_entityInitCache;
+
+template <typename original_t>
+ENTITYINIT CEntityInitCache::Resolve(char *classname, original_t original)
+{
+	if (!m_remaps.empty())
+	{
+		auto remap = m_remaps.find(classname);
+		if (remap != m_remaps.end())
+			classname = const_cast<char *>(remap->second.c_str());
+	}
+
+	if (!m_hook->pre.empty() || !m_hook->post.empty())
+		return original(classname);
+
+	auto cached = m_cache.find(classname);
+	if (cached != m_cache.end())
+		return cached->second;
+
+	ENTITYINIT pfnInit = original(classname);
+	m_cache.emplace(AddName(m_cacheNames, classname), pfnInit);
+	return pfnInit;
+}
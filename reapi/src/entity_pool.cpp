@@ -0,0 +1,198 @@
+#include "precompiled.h"
+
+CEntityPools g_entityPools;
+
+int CEntityPools::Create(int tpl, size_t count)
+{
+	if (m_slots.size() < size_t(gpGlobals->maxEntities + 1))
+		m_slots.resize(gpGlobals->maxEntities + 1, { 0, false });
+
+	// reuse a free handle
+	size_t i = 0;
+	while (i < m_pools.size() && m_pools[i])
+		i++;
+
+	if (i == m_pools.size())
+		m_pools.push_back(nullptr);
+
+	int handle = i + 1;
+
+	auto pool = new pool_t;
+	pool->tpl = tpl;
+	pool->snapshot = 0;
+	pool->free.reserve(count);
+
+	for (size_t n = 0; n < count; n++)
+	{
+		edict_t *pEdict = g_entityTemplates.Spawn(tpl, Vector(0, 0, 0), Vector(0, 0, 0), nullptr);
+		if (!pEdict)
+			break;
+
+		// the state to restore on acquire
+		if (!pool->snapshot)
+			pool->snapshot = g_entitySnapshots.Create(pEdict);
+
+		Hide(pEdict);
+
+		int index = indexOfEdict(pEdict);
+		m_slots[index] = { handle, false };
+		pool->free.push_back(index);
+	}
+
+	if (pool->free.empty()) {
+		delete pool;
+		return 0;
+	}
+
+	m_pools[handle - 1] = pool;
+	Hook(true);
+	return handle;
+}
+
+bool CEntityPools::Remove(int handle)
+{
+	if (!IsValid(handle))
+		return false;
+
+	auto pool = m_pools[handle - 1];
+
+	// the acquired entities are left to the plugin
+	for (auto &slot : m_slots)
+	{
+		if (slot.pool == handle)
+			slot.pool = 0;
+	}
+
+	for (auto index : pool->free)
+		REMOVE_ENTITY(edictByIndex(index));
+
+	g_entitySnapshots.Remove(pool->snapshot);
+	delete pool;
+	m_pools[handle - 1] = nullptr;
+
+	if (std::find_if(m_pools.begin(), m_pools.end(), [](pool_t *p) { return p != nullptr; }) == m_pools.end())
+		Hook(false);
+
+	return true;
+}
+
+void CEntityPools::Clear()
+{
+	// the entities are freed by the engine on map change
+	for (auto pool : m_pools)
+	{
+		if (pool) {
+			g_entitySnapshots.Remove(pool->snapshot);
+			delete pool;
+		}
+	}
+
+	m_pools.clear();
+	m_slots.clear();
+	Hook(false);
+}
+
+void CEntityPools::Hook(bool hook)
+{
+	if (m_hooked == hook)
+		return;
+
+	if (hook) {
+		g_hookManager.getHook(RH_ED_Alloc)->acquire();
+		g_hookManager.getHook(RH_ED_Free)->acquire();
+	}
+	else {
+		g_hookManager.getHook(RH_ED_Alloc)->release();
+		g_hookManager.getHook(RH_ED_Free)->release();
+	}
+
+	m_hooked = hook;
+}
+
+CEntityPools::slot_t *CEntityPools::GetSlot(edict_t *pEdict)
+{
+	if (m_slots.empty() || !pEdict)
+		return nullptr;
+
+	size_t index = indexOfEdict(pEdict);
+	if (index >= m_slots.size() || !m_slots[index].pool)
+		return nullptr;
+
+	return &m_slots[index];
+}
+
+void CEntityPools::Hide(edict_t *pEdict)
+{
+	EntityCallbackDispatcher().DeleteExistingCallbacks(getPrivate<CBaseEntity>(pEdict));
+
+	entvars_t *pev = &pEdict->v;
+	pev->flags &= ~FL_KILLME;
+	pev->effects |= EF_NODRAW;
+	pev->solid = SOLID_NOT;
+	pev->movetype = MOVETYPE_NONE;
+	pev->takedamage = DAMAGE_NO;
+	pev->velocity = Vector(0, 0, 0);
+	pev->avelocity = Vector(0, 0, 0);
+	pev->nextthink = 0;
+	pev->owner = nullptr;
+	pev->aiment = nullptr;
+
+	SET_ORIGIN(pEdict, pev->origin);
+}
+
+edict_t *CEntityPools::Acquire(int handle, const Vector &origin, const Vector &angles, edict_t *pOwner)
+{
+	auto pool = m_pools[handle - 1];
+	if (pool->free.empty())
+		return nullptr;
+
+	int index = pool->free.back();
+	pool->free.pop_back();
+	m_slots[index].used = true;
+
+	edict_t *pEdict = edictByIndex(index);
+
+	if (g_entitySnapshots.IsValid(pool->snapshot))
+		g_entitySnapshots.Restore(pool->snapshot, pEdict);
+
+	if (g_entityTemplates.IsValid(pool->tpl)) {
+		g_entityTemplates.Place(pool->tpl, pEdict, origin, angles, pOwner);
+	}
+	else {
+		pEdict->v.owner = pOwner;
+		pEdict->v.angles = angles;
+		SET_ORIGIN(pEdict, origin);
+	}
+
+	return pEdict;
+}
+
+bool CEntityPools::Release(edict_t *pEdict)
+{
+	slot_t *slot = GetSlot(pEdict);
+	if (!slot)
+		return false;
+
+	if (slot->used)
+	{
+		slot->used = false;
+		Hide(pEdict);
+		m_pools[slot->pool - 1]->free.push_back(indexOfEdict(pEdict));
+	}
+
+	return true;
+}
+
+void CEntityPools::OnAlloc(edict_t *pEdict)
+{
+	slot_t *slot = GetSlot(pEdict);
+	if (!slot)
+		return;
+
+	// freed behind the pool
+	auto &free = m_pools[slot->pool - 1]->free;
+	free.erase(std::remove(free.begin(), free.end(), indexOfEdict(pEdict)), free.end());
+
+	slot->pool = 0;
+	slot->used = false;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+// Pools of hidden entities spawned from a template and reused by the plugins.
+// Released entity is reset in place instead of being freed, the frees of the pooled
+// entities are caught in ED_Free so the edicts are never handed to anybody else.
+class CEntityPools
+{
+public:
+	int Create(int tpl, size_t count);
+	bool Remove(int handle);
+	void Clear();
+
+	bool IsValid(int handle) const
+	{
+		return handle > 0 && size_t(handle) <= m_pools.size() && m_pools[handle - 1];
+	}
+
+	size_t GetFreeCount(int handle) const { return m_pools[handle - 1]->free.size(); }
+
+	edict_t *Acquire(int handle, const Vector &origin, const Vector &angles, edict_t *pOwner);
+	bool Release(edict_t *pEdict);      // false if the entity isn't pooled
+
+	// the edict given by ED_Alloc can't be pooled anymore
+	void OnAlloc(edict_t *pEdict);
+
+private:
+	struct pool_t
+	{
+		int tpl;                    // template of the entities
+		int snapshot;               // state of the entity right after the spawn
+		std::vector<int> free;      // hidden entities
+	};
+
+	struct slot_t
+	{
+		int pool;                   // pool handle, 0 if not pooled
+		bool used;
+	};
+
+	static void Hide(edict_t *pEdict);
+	slot_t *GetSlot(edict_t *pEdict);
+	void Hook(bool hook);
+
+	std::vector<pool_t *> m_pools;  // handle is index + 1
+	std::vector<slot_t> m_slots;    // by entity index
+	bool m_hooked = false;
+};
+
+extern CEntityPools g_entityPools;
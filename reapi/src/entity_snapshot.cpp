@@ -0,0 +1,203 @@
+#include "precompiled.h"
+
+CEntitySnapshots g_entitySnapshots;
+
+// tables of the members living in entvars or private data of the entity
+static const memberlist_t::members_tables_e snapshot_tables[] =
+{
+	memberlist_t::mt_entvars,
+	memberlist_t::mt_base,
+	memberlist_t::mt_animating,
+	memberlist_t::mt_basemonster,
+	memberlist_t::mt_player,
+	memberlist_t::mt_baseitem,
+	memberlist_t::mt_baseweapon,
+	memberlist_t::mt_weaponbox,
+	memberlist_t::mt_armoury,
+	memberlist_t::mt_grenade,
+	memberlist_t::mt_p228,
+	memberlist_t::mt_scout,
+	memberlist_t::mt_hegrenade,
+	memberlist_t::mt_xm1014,
+	memberlist_t::mt_c4,
+	memberlist_t::mt_mac10,
+	memberlist_t::mt_aug,
+	memberlist_t::mt_smokegrenade,
+	memberlist_t::mt_elite,
+	memberlist_t::mt_fiveseven,
+	memberlist_t::mt_ump45,
+	memberlist_t::mt_sg550,
+	memberlist_t::mt_galil,
+	memberlist_t::mt_famas,
+	memberlist_t::mt_usp,
+	memberlist_t::mt_glock18,
+	memberlist_t::mt_awp,
+	memberlist_t::mt_mp5n,
+	memberlist_t::mt_m249,
+	memberlist_t::mt_m3,
+	memberlist_t::mt_m4a1,
+	memberlist_t::mt_tmp,
+	memberlist_t::mt_g3sg1,
+	memberlist_t::mt_deagle,
+	memberlist_t::mt_sg552,
+	memberlist_t::mt_ak47,
+	memberlist_t::mt_knife,
+	memberlist_t::mt_p90,
+	memberlist_t::mt_shield,
+	memberlist_t::mt_mapinfo,
+	memberlist_t::mt_gib,
+};
+
+static bool isPlainMember(const member_t *member)
+{
+	switch (member->type)
+	{
+	case MEMBER_FLOAT:
+	case MEMBER_DOUBLE:
+	case MEMBER_VECTOR:
+	case MEMBER_QSTRING:
+	case MEMBER_INTEGER:
+	case MEMBER_SHORT:
+	case MEMBER_BYTE:
+	case MEMBER_BOOL:
+	case MEMBER_SIGNALS:
+	case MEBMER_REBUYSTRUCT:
+	case MEMBER_PMTRACE:
+	case MEBMER_USERCMD:
+		return true;
+	case MEMBER_STRING:
+		// char arrays only, not pointers
+		return member->max_size != sizeof(char *);
+	default:
+		return false;
+	}
+}
+
+void CEntitySnapshots::BuildSpans()
+{
+	m_spans.resize(arraysize(snapshot_tables));
+
+	for (size_t table = 0; table < arraysize(snapshot_tables); table++)
+	{
+		auto &spans = m_spans[table];
+
+		for (size_t index = 0; index < MAX_REGION_RANGE; index++)
+		{
+			member_t *member = memberlist[snapshot_tables[table] * MAX_REGION_RANGE + index];
+			if (!member)
+				break;
+
+			if (isPlainMember(member))
+				spans.push_back({ member->offset, member->max_size });
+		}
+
+		std::sort(spans.begin(), spans.end(), [](const span_t &a, const span_t &b) { return a.offset < b.offset; });
+
+		// merge the neighbouring members into a single copy
+		size_t merged = 0;
+		for (size_t i = 1; i < spans.size(); i++)
+		{
+			auto &last = spans[merged];
+			if (spans[i].offset <= last.offset + last.size) {
+				last.size = max(last.size, spans[i].offset + spans[i].size - last.offset);
+				continue;
+			}
+
+			spans[++merged] = spans[i];
+		}
+
+		if (!spans.empty())
+			spans.resize(merged + 1);
+	}
+}
+
+void *CEntitySnapshots::GetBase(size_t table, edict_t *pEdict)
+{
+	if (snapshot_tables[table] == memberlist_t::mt_entvars)
+		return &pEdict->v;
+
+	// the table belongs to the class of the entity
+	member_t *member = memberlist[snapshot_tables[table] * MAX_REGION_RANGE];
+	if (!member->pfnIsRefsToClass || !member->pfnIsRefsToClass(pEdict->pvPrivateData))
+		return nullptr;
+
+	return pEdict->pvPrivateData;
+}
+
+int CEntitySnapshots::Create(edict_t *pEdict)
+{
+	if (m_spans.empty())
+		BuildSpans();
+
+	auto snapshot = new snapshot_t;
+	snapshot->entity = indexOfEdict(pEdict);
+
+	for (size_t table = 0; table < m_spans.size(); table++)
+	{
+		auto base = (uint8 *)GetBase(table, pEdict);
+		if (!base)
+			continue;
+
+		snapshot->tables.push_back(table);
+
+		for (auto &span : m_spans[table])
+			snapshot->data.insert(snapshot->data.end(), base + span.offset, base + span.offset + span.size);
+	}
+
+	// reuse the free handle
+	for (size_t i = 0; i < m_snapshots.size(); i++)
+	{
+		if (!m_snapshots[i]) {
+			m_snapshots[i] = snapshot;
+			return i + 1;
+		}
+	}
+
+	m_snapshots.push_back(snapshot);
+	return m_snapshots.size();
+}
+
+bool CEntitySnapshots::Restore(int handle, edict_t *pEdict) const
+{
+	auto snapshot = m_snapshots[handle - 1];
+
+	// the entity has to be of the same class
+	for (auto table : snapshot->tables)
+	{
+		if (!GetBase(table, pEdict))
+			return false;
+	}
+
+	const uint8 *src = snapshot->data.data();
+	for (auto table : snapshot->tables)
+	{
+		auto base = (uint8 *)GetBase(table, pEdict);
+
+		for (auto &span : m_spans[table]) {
+			Q_memcpy(base + span.offset, src, span.size);
+			src += span.size;
+		}
+	}
+
+	// relink the entity at the restored position
+	SET_ORIGIN(pEdict, pEdict->v.origin);
+	return true;
+}
+
+bool CEntitySnapshots::Remove(int handle)
+{
+	if (!IsValid(handle))
+		return false;
+
+	delete m_snapshots[handle - 1];
+	m_snapshots[handle - 1] = nullptr;
+	return true;
+}
+
+void CEntitySnapshots::Clear()
+{
+	for (auto snapshot : m_snapshots)
+		delete snapshot;
+
+	m_snapshots.clear();
+}
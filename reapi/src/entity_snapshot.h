@@ -0,0 +1,41 @@
+#pragma once
+
+// Snapshots of entvars and private members of the entities.
+// Only plain data is saved, references to other entities are left as is on restore.
+class CEntitySnapshots
+{
+public:
+	int Create(edict_t *pEdict);
+	bool Restore(int handle, edict_t *pEdict) const;
+	bool Remove(int handle);
+	void Clear();
+
+	bool IsValid(int handle) const
+	{
+		return handle > 0 && size_t(handle) <= m_snapshots.size() && m_snapshots[handle - 1];
+	}
+
+	int GetEntity(int handle) const { return m_snapshots[handle - 1]->entity; }
+
+private:
+	struct span_t
+	{
+		size_t offset;
+		size_t size;
+	};
+
+	struct snapshot_t
+	{
+		int entity;                         // entity of the snapshot
+		std::vector<size_t> tables;         // saved tables, see snapshot_tables
+		std::vector<uint8> data;
+	};
+
+	void BuildSpans();
+	static void *GetBase(size_t table, edict_t *pEdict);
+
+	std::vector<std::vector<span_t>> m_spans;   // merged plain members of the tables
+	std::vector<snapshot_t *> m_snapshots;      // handle is index + 1
+};
+
+extern CEntitySnapshots g_entitySnapshots;
@@ -0,0 +1,235 @@
+#include "precompiled.h"
+
+CEntityTemplates g_entityTemplates;
+
+int CEntityTemplates::Create(const char *classname, bool useHashTable)
+{
+	auto tpl = new template_t;
+	tpl->classname = ALLOC_STRING(classname);
+	tpl->useHashTable = useHashTable;
+	tpl->model = iStringNull;
+	tpl->hasSize = false;
+	tpl->think.amx = nullptr;
+	tpl->touch.amx = nullptr;
+
+	// reuse a free handle
+	for (size_t i = 0; i < m_templates.size(); i++)
+	{
+		if (!m_templates[i]) {
+			m_templates[i] = tpl;
+			return i + 1;
+		}
+	}
+
+	m_templates.push_back(tpl);
+	return m_templates.size();
+}
+
+bool CEntityTemplates::Remove(int handle)
+{
+	if (!IsValid(handle))
+		return false;
+
+	delete m_templates[handle - 1];
+	m_templates[handle - 1] = nullptr;
+	return true;
+}
+
+void CEntityTemplates::Clear()
+{
+	for (auto tpl : m_templates)
+		delete tpl;
+
+	m_templates.clear();
+}
+
+void CEntityTemplates::SetModel(int handle, const char *model)
+{
+	m_templates[handle - 1]->model = (model && model[0] != '\0') ? ALLOC_STRING(model) : iStringNull;
+}
+
+void CEntityTemplates::SetSize(int handle, const Vector &mins, const Vector &maxs)
+{
+	auto tpl = m_templates[handle - 1];
+	tpl->hasSize = true;
+	tpl->mins = mins;
+	tpl->maxs = maxs;
+}
+
+bool CEntityTemplates::SetField(AMX *amx, int handle, cell id, const cell *value, size_t element)
+{
+	const member_t *member = memberlist[id];
+
+	field_t field;
+	field.id = id;
+	field.member = nullptr;
+	field.offset = member->offset;
+
+	auto setData = [&field, element](const void *data, size_t size)
+	{
+		field.offset += element * size;
+		field.data.assign((const uint8 *)data, (const uint8 *)data + size);
+	};
+
+	switch (member->type)
+	{
+	case MEMBER_FLOAT:
+	case MEMBER_INTEGER:
+		setData(value, sizeof(int));
+		break;
+	case MEMBER_SHORT:
+	{
+		short data = *value;
+		setData(&data, sizeof(data));
+		break;
+	}
+	case MEMBER_BYTE:
+	{
+		byte data = *value;
+		setData(&data, sizeof(data));
+		break;
+	}
+	case MEMBER_BOOL:
+	{
+		bool data = *value != 0;
+		setData(&data, sizeof(data));
+		break;
+	}
+	case MEMBER_DOUBLE:
+	{
+		double data = *(float *)value;
+		setData(&data, sizeof(data));
+		break;
+	}
+	case MEMBER_VECTOR:
+		setData(value, sizeof(Vector));
+		break;
+	case MEMBER_QSTRING:
+	{
+		char string[2048];
+		const char *source = getAmxString(const_cast<cell *>(value), string);
+		string_t data = (source && source[0] != '\0') ? ALLOC_STRING(source) : iStringNull;
+		setData(&data, sizeof(data));
+		break;
+	}
+	case MEMBER_STRING:
+	{
+		char string[2048];
+		const char *source = getAmxString(const_cast<cell *>(value), string);
+
+		if (member->max_size > sizeof(char *)) {
+			// char []
+			field.data.resize(member->max_size);
+			strncpy((char *)field.data.data(), source, member->max_size - 1);
+			break;
+		}
+
+		// char *, has to be allocated for each entity
+		field.member = member;
+		field.value.assign(value, value + strlen(source) + 1);
+		break;
+	}
+	default:
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: member type %i isn't supported by the templates", __FUNCTION__, member->type);
+		return false;
+	}
+
+	bool entvars = (id / MAX_REGION_RANGE) == memberlist_t::mt_entvars;
+	auto &fields = entvars ? m_templates[handle - 1]->entvars : m_templates[handle - 1]->members;
+
+	// the field set again replaces the old value
+	for (auto &old : fields)
+	{
+		if (old.id == field.id && old.offset == field.offset) {
+			old = std::move(field);
+			return true;
+		}
+	}
+
+	fields.push_back(std::move(field));
+	return true;
+}
+
+bool CEntityTemplates::SetCallback(AMX *amx, int handle, CEntityCallbackDispatcher::CallbackType type, const char *funcname, const cell *params, size_t len, float delay)
+{
+	auto tpl = m_templates[handle - 1];
+	auto &callback = (type == CEntityCallbackDispatcher::Think) ? tpl->think : tpl->touch;
+
+	if (!funcname || funcname[0] == '\0') {
+		callback.amx = nullptr;
+		return true;
+	}
+
+	callback.amx = amx;
+	callback.funcname = funcname;
+	callback.params.assign(params, params + len);
+	callback.delay = delay;
+	return true;
+}
+
+void CEntityTemplates::ApplyFields(const std::vector<field_t> &fields, edict_t *pEdict, bool entvars)
+{
+	for (auto &field : fields)
+	{
+		void *base = entvars ? &pEdict->v : get_pdata_custom(getPrivate<CBaseEntity>(pEdict), field.id);
+		if (!base)
+			continue;
+
+		if (field.member) {
+			set_member(nullptr, base, field.member, const_cast<cell *>(field.value.data()), 0);
+			continue;
+		}
+
+		Q_memcpy((uint8 *)base + field.offset, field.data.data(), field.data.size());
+	}
+}
+
+edict_t *CEntityTemplates::Spawn(int handle, const Vector &origin, const Vector &angles, edict_t *pOwner) const
+{
+	auto tpl = m_templates[handle - 1];
+
+	edict_t *pEdict;
+	if (tpl->useHashTable)
+		pEdict = g_ReGameFuncs->CREATE_NAMED_ENTITY2(tpl->classname);
+	else
+		pEdict = CREATE_NAMED_ENTITY(tpl->classname);
+
+	if (!pEdict || !pEdict->pvPrivateData)
+		return nullptr;
+
+	if (!FStringNull(tpl->model))
+		SET_MODEL(pEdict, STRING(tpl->model));
+
+	if (tpl->hasSize)
+		SET_SIZE(pEdict, tpl->mins, tpl->maxs);
+
+	ApplyFields(tpl->entvars, pEdict, true);
+	ApplyFields(tpl->members, pEdict, false);
+
+	Place(handle, pEdict, origin, angles, pOwner);
+	return pEdict;
+}
+
+void CEntityTemplates::Place(int handle, edict_t *pEdict, const Vector &origin, const Vector &angles, edict_t *pOwner) const
+{
+	auto tpl = m_templates[handle - 1];
+
+	pEdict->v.owner = pOwner;
+	pEdict->v.angles = angles;
+	SET_ORIGIN(pEdict, origin);
+
+	CBaseEntity *pEntity = getPrivate<CBaseEntity>(pEdict);
+
+	if (tpl->think.amx)
+	{
+		auto &think = tpl->think;
+		if (EntityCallbackDispatcher().SetThink(think.amx, pEntity, think.funcname.c_str(), think.params.data(), think.params.size()))
+			pEdict->v.nextthink = gpGlobals->time + think.delay;
+	}
+
+	if (tpl->touch.amx)
+	{
+		auto &touch = tpl->touch;
+		EntityCallbackDispatcher().SetTouch(touch.amx, pEntity, touch.funcname.c_str(), touch.params.data(), touch.params.size());
+	}
+}
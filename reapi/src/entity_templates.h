@@ -0,0 +1,64 @@
+#pragma once
+
+// Entity templates defined once by a plugin and spawned by a single call.
+// The plain fields are converted to raw bytes when they are set to the template
+// and copied to each spawned entity.
+class CEntityTemplates
+{
+public:
+	int Create(const char *classname, bool useHashTable);
+	bool Remove(int handle);
+	void Clear();
+
+	bool IsValid(int handle) const
+	{
+		return handle > 0 && size_t(handle) <= m_templates.size() && m_templates[handle - 1];
+	}
+
+	void SetModel(int handle, const char *model);
+	void SetSize(int handle, const Vector &mins, const Vector &maxs);
+	bool SetField(AMX *amx, int handle, cell id, const cell *value, size_t element);
+	bool SetCallback(AMX *amx, int handle, CEntityCallbackDispatcher::CallbackType type, const char *funcname, const cell *params, size_t len, float delay = 0);
+
+	edict_t *Spawn(int handle, const Vector &origin, const Vector &angles, edict_t *pOwner) const;
+
+	// sets the owner, position and callbacks of the template to the entity
+	void Place(int handle, edict_t *pEdict, const Vector &origin, const Vector &angles, edict_t *pOwner) const;
+
+private:
+	struct field_t
+	{
+		cell id;                    // member id
+		const member_t *member;     // set by set_member if not null, copied otherwise
+		size_t offset;
+		std::vector<uint8> data;    // raw value
+		std::vector<cell> value;    // value for set_member
+	};
+
+	struct callback_t
+	{
+		AMX *amx;
+		std::string funcname;
+		std::vector<cell> params;
+		float delay;
+	};
+
+	struct template_t
+	{
+		string_t classname;
+		bool useHashTable;
+		string_t model;
+		bool hasSize;
+		Vector mins, maxs;
+		std::vector<field_t> entvars;
+		std::vector<field_t> members;
+		callback_t think;
+		callback_t touch;
+	};
+
+	static void ApplyFields(const std::vector<field_t> &fields, edict_t *pEdict, bool entvars);
+
+	std::vector<template_t *> m_templates;  // handle is index + 1
+};
+
+extern CEntityTemplates g_entityTemplates;
@@ -3,6 +3,127 @@
 hookctx_t* g_hookCtx = nullptr;
 CTempStrings hookctx_t::s_temp_strings;
 
+cell amxpush_t::exec(CAmxxHookBase *fwd)
+{
+	cell ret = 0;
+	int err = error;
+
+	if (likely(err == AMX_ERR_NONE)) {
+		err = g_amxxapi.amx_Exec(amx, &ret, fwd->GetFuncIndex());
+		copyBack();
+	}
+	else {
+		// couldn't push all the arguments, drop the pushed ones
+		amx->stk = stk;
+		amx->paramcount = 0;
+	}
+
+	amx->hea = hea;
+	amx->error = AMX_ERR_NONE;
+
+	if (unlikely(err != AMX_ERR_NONE))
+	{
+		// the plugin has failed on its own (set_fail_state), AMX Mod X has logged it already
+		if (err == AMX_ERR_EXIT) {
+			fwd->SetState(FSTATE_STOPPED);
+		}
+		else {
+			fwd->Error(err, "Failed to execute the hookchain handler, add \"debug\" after the plugin name to get a backtrace.");
+		}
+
+		return HC_CONTINUE;
+	}
+
+	return ret;
+}
+
+CDeferredHooks g_deferredHooks;
+
+void CDeferredHooks::Flush()
+{
+	if (m_buffer.empty())
+		return;
+
+	// handlers can defer the new calls, they go to the next frame
+	m_buffer.swap(m_delivering);
+
+	for (size_t pos = 0; pos < m_delivering.size(); pos += m_delivering[pos + rec_size]) {
+		Execute(&m_delivering[pos]);
+	}
+
+	m_delivering.clear();
+}
+
+void CDeferredHooks::Clear()
+{
+	m_buffer.clear();
+	m_delivering.clear();
+}
+
+void CDeferredHooks::Execute(cell *rec)
+{
+	// the handler could be removed or disabled since the call
+	auto fwd = g_hookManager.getAmxxHook(rec[rec_handle]);
+	if (!fwd || fwd->GetState() != FSTATE_ENABLED)
+		return;
+
+	// paused or stopped plugin
+	if (!fwd->CanExecDirect())
+		return;
+
+	size_t argc = rec[rec_argc];
+	cell *args[MAX_HOOKCHAIN_ARGS];
+
+	cell *arg = rec + rec_args;
+	for (size_t i = 0; i < argc; i++)
+	{
+		args[i] = arg;
+
+		switch (arg[0])
+		{
+		case arg_string:
+			arg += 2 + (arg[1] + sizeof(cell)) / sizeof(cell);
+			break;
+		case arg_vector:
+			arg += 1 + 3;
+			break;
+		default:
+			arg += 2;
+			break;
+		}
+	}
+
+	hookctx_t hookCtx;
+	hookCtx.SetId(rec[rec_handle]);
+	hookCtx.reset(static_cast<AType>(rec[rec_rettype]));
+	hookCtx.retVal.set = rec[rec_retset] != FALSE;
+	hookCtx.retVal._integer = rec[rec_retval];
+
+	hookctx_t *save = g_hookCtx;
+	g_hookCtx = &hookCtx;
+
+	// AMX takes the parameters in reverse order
+	amxpush_t ctx(fwd->GetAmx());
+	for (size_t i = argc; i-- > 0;)
+	{
+		switch (args[i][0])
+		{
+		case arg_string:
+			amxPushArg(ctx, (const char *)&args[i][2]);
+			break;
+		case arg_vector:
+			amxPushArg(ctx, amxvector_t(*(Vector *)&args[i][1]));
+			break;
+		default:
+			amxPushCell(ctx, args[i][1]);
+			break;
+		}
+	}
+
+	ctx.exec(fwd);
+	g_hookCtx = save;
+}
+
 /*
 * ReHLDS functions
 */
@@ -65,6 +186,8 @@ void SV_WriteFullClientUpdate(IRehldsHook_SV_WriteFullClientUpdate *chain, IGame
 
 void Con_Printf(IRehldsHook_Con_Printf *chain, const char *string)
 {
+	g_logTap.Push(string);
+
 	auto original = [chain](const char *_string)
 	{
 		chain->callNext(_string);
@@ -80,7 +203,13 @@ ENTITYINIT GetEntityInit(IRehldsHook_GetEntityInit *chain, char *classname)
 		return chain->callNext(_classname);
 	};
 
-	return callForward<ENTITYINIT>(RH_GetEntityInit, original, classname);
+	// the classname remapped by the rules goes through the hookchain
+	auto resolve = [&original](char *_classname)
+	{
+		return callForward<ENTITYINIT>(RH_GetEntityInit, original, _classname);
+	};
+
+	return g_entityInitCache.Resolve(classname, resolve);
 }
 
 void ClientConnected(IRehldsHook_ClientConnected* chain, IGameClient* cl)
@@ -127,11 +256,17 @@ edict_t *ED_Alloc(IRehldsHook_ED_Alloc* chain)
 		return indexOfEdict(chain->callNext());
 	};
 
-	return edictByIndexAmx(callForward<size_t>(RH_ED_Alloc, original));
+	edict_t *pEdict = edictByIndexAmx(callForward<size_t>(RH_ED_Alloc, original));
+	g_entityPools.OnAlloc(pEdict);
+	return pEdict;
 }
 
 void ED_Free(IRehldsHook_ED_Free* chain, edict_t *entity)
 {
+	// the pooled entity goes back to its pool
+	if (g_entityPools.Release(entity))
+		return;
+
 	auto original = [chain](int _entity)
 	{
 		chain->callNext(edictByIndexAmx(_entity));
@@ -172,7 +307,13 @@ int PF_precache_generic_I(IRehldsHook_PF_precache_generic_I *chain, const char *
 		return chain->callNext(_s);
 	};
 
-	return callForward<int>(RH_PF_precache_generic_I, original, s);
+	// the path replaced by the rules goes through the hookchain
+	auto precache = [&original](const char *_s)
+	{
+		return callForward<int>(RH_PF_precache_generic_I, original, _s);
+	};
+
+	return g_precacheRegistry.Precache(PT_GENERIC, s, precache);
 }
 
 int PF_precache_model_I(IRehldsHook_PF_precache_model_I *chain, char *s)
@@ -182,7 +323,13 @@ int PF_precache_model_I(IRehldsHook_PF_precache_model_I *chain, char *s)
 		return chain->callNext(_s);
 	};
 
-	return callForward<int>(RH_PF_precache_model_I, original, s);
+	// the path replaced by the rules goes through the hookchain
+	auto precache = [&original](char *_s)
+	{
+		return callForward<int>(RH_PF_precache_model_I, original, _s);
+	};
+
+	return g_precacheRegistry.Precache(PT_MODEL, s, precache);
 }
 
 int PF_precache_sound_I(IRehldsHook_PF_precache_sound_I *chain, const char *s)
@@ -192,7 +339,13 @@ int PF_precache_sound_I(IRehldsHook_PF_precache_sound_I *chain, const char *s)
 		return chain->callNext(_s);
 	};
 
-	return callForward<int>(RH_PF_precache_sound_I, original, s);
+	// the path replaced by the rules goes through the hookchain
+	auto precache = [&original](const char *_s)
+	{
+		return callForward<int>(RH_PF_precache_sound_I, original, _s);
+	};
+
+	return g_precacheRegistry.Precache(PT_SOUND, s, precache);
 }
 
 unsigned short EV_Precache_AMXX(EventPrecache_t *data, const char *psz)
@@ -289,7 +442,7 @@ void CBasePlayer_TraceAttack(IReGameHook_CBasePlayer_TraceAttack *chain, CBasePl
 {
 	Vector vecDirCopy(vecDir);
 
-	auto original = [chain, &vecDirCopy](int _pthis, int _pevAttacker, float _flDamage, cell _vecDir, TraceResult *_ptr, int _bitsDamageType)
+	auto original = [chain, &vecDirCopy](int _pthis, int _pevAttacker, float _flDamage, amxvector_t _vecDir, TraceResult *_ptr, int _bitsDamageType)
 	{
 		chain->callNext(getPrivate<CBasePlayer>(_pthis), PEV(_pevAttacker), _flDamage, vecDirCopy, _ptr, _bitsDamageType);
 	};
@@ -414,6 +567,7 @@ void CBasePlayer_PreThink(IReGameHook_CBasePlayer_PreThink *chain, CBasePlayer *
 		chain->callNext(getPrivate<CBasePlayer>(_pthis));
 	};
 
+	g_thinkBatch.Think(CThinkBatch::BATCH_PRETHINK, indexOfEdict(pthis->pev));
 	callVoidForward(RG_CBasePlayer_PreThink, original, indexOfEdict(pthis->pev));
 }
 
@@ -424,6 +578,7 @@ void CBasePlayer_PostThink(IReGameHook_CBasePlayer_PostThink *chain, CBasePlayer
 		chain->callNext(getPrivate<CBasePlayer>(_pthis));
 	};
 
+	g_thinkBatch.Think(CThinkBatch::BATCH_POSTTHINK, indexOfEdict(pthis->pev));
 	callVoidForward(RG_CBasePlayer_PostThink, original, indexOfEdict(pthis->pev));
 }
 
@@ -631,7 +786,7 @@ void CBasePlayer_StartObserver(IReGameHook_CBasePlayer_StartObserver *chain, CBa
 {
 	Vector vecPositionCopy(vecPosition), vecViewAngleCopy(vecViewAngle);
 
-	auto original = [chain, &vecPositionCopy, &vecViewAngleCopy](int _pthis, cell _vecPosition, cell _vecViewAngle)
+	auto original = [chain, &vecPositionCopy, &vecViewAngleCopy](int _pthis, amxvector_t _vecPosition, amxvector_t _vecViewAngle)
 	{
 		chain->callNext(getPrivate<CBasePlayer>(_pthis), vecPositionCopy, vecViewAngleCopy);
 	};
@@ -673,7 +828,7 @@ void PlayerBlind(IReGameHook_PlayerBlind *chain, CBasePlayer *pPlayer, entvars_t
 {
 	Vector colorCopy(color);
 
-	auto original = [chain, &colorCopy](int _pPlayer, int _pevInflictor, int _pevAttacker, float _fadeTime, float _fadeHold, int _alpha, cell _color)
+	auto original = [chain, &colorCopy](int _pPlayer, int _pevInflictor, int _pevAttacker, float _fadeTime, float _fadeHold, int _alpha, amxvector_t _color)
 	{
 		chain->callNext(getPrivate<CBasePlayer>(_pPlayer), PEV(_pevInflictor), PEV(_pevAttacker), _fadeTime, _fadeHold, _alpha, colorCopy);
 	};
@@ -685,7 +840,7 @@ void RadiusFlash_TraceLine(IReGameHook_RadiusFlash_TraceLine *chain, CBasePlayer
 {
 	Vector vecSrcCopy(vecSrc), vecSpotCopy(vecSpot);
 
-	auto original = [chain, &vecSrcCopy, &vecSpotCopy](int _pPlayer, int _pevInflictor, int _pevAttacker, cell _vecSrc, cell _vecSpot, TraceResult *_ptr)
+	auto original = [chain, &vecSrcCopy, &vecSpotCopy](int _pPlayer, int _pevInflictor, int _pevAttacker, amxvector_t _vecSrc, amxvector_t _vecSpot, TraceResult *_ptr)
 	{
 		chain->callNext(getPrivate<CBasePlayer>(_pPlayer), PEV(_pevInflictor), PEV(_pevAttacker), vecSrcCopy, vecSpotCopy, _ptr);
 	};
@@ -707,7 +862,9 @@ void PM_Move_AMXX(Move_t *data, int playerIndex)
 {
 	auto original = [data](int _playerIndex)
 	{
+		g_moveModifiers.PreMove(data->m_args.ppmove);
 		data->m_chain->callNext(data->m_args.ppmove, data->m_args.server);
+		g_moveModifiers.PostMove(data->m_args.ppmove);
 	};
 
 	callVoidForward(RG_PM_Move, original, playerIndex);
@@ -1056,7 +1213,7 @@ CGrenade *CBasePlayer_ThrowGrenade(IReGameHook_CBasePlayer_ThrowGrenade *chain,
 {
 	Vector vecSrcCopy(vecSrc), vecThrowCopy(vecThrow);
 
-	auto original = [chain, &vecSrcCopy, &vecThrowCopy](int _pthis, int _pWeapon, cell _vecSrc, cell _vecThrow, float _time, unsigned short _usEvent)
+	auto original = [chain, &vecSrcCopy, &vecThrowCopy](int _pthis, int _pWeapon, amxvector_t _vecSrc, amxvector_t _vecThrow, float _time, unsigned short _usEvent)
 	{
 		return indexOfPDataAmx(chain->callNext(getPrivate<CBasePlayer>(_pthis), getPrivate<CBasePlayerWeapon>(_pWeapon), vecSrcCopy, vecThrowCopy, _time, _usEvent));
 	};
@@ -1066,9 +1223,23 @@ CGrenade *CBasePlayer_ThrowGrenade(IReGameHook_CBasePlayer_ThrowGrenade *chain,
 
 bool CSGameRules_CanPlayerHearPlayer(IReGameHook_CSGameRules_CanPlayerHearPlayer *chain, CBasePlayer *pListener, CBasePlayer *pSender)
 {
+	bool canHear;
+
+	// the pair decided by the voice matrix, no need to go through AMX
+	auto hook = g_hookManager.getHook(RG_CSGameRules_CanPlayerHearPlayer);
+	if (!hook->pre.size() && !hook->post.size() && g_voiceMatrix.CanHear(pListener, pSender, canHear))
+		return canHear;
+
 	auto original = [chain](int _pListener, int _pSender)
 	{
-		return chain->callNext(getPrivate<CBasePlayer>(_pListener), getPrivate<CBasePlayer>(_pSender));
+		CBasePlayer *pListener = getPrivate<CBasePlayer>(_pListener);
+		CBasePlayer *pSender = getPrivate<CBasePlayer>(_pSender);
+
+		bool canHear;
+		if (g_voiceMatrix.CanHear(pListener, pSender, canHear))
+			return canHear;
+
+		return chain->callNext(pListener, pSender);
 	};
 
 	return callForward<bool>(RG_CSGameRules_CanPlayerHearPlayer, original, indexOfEdict(pListener->pev), indexOfEdict(pSender->pev));
@@ -1148,7 +1319,7 @@ CGrenade *ThrowHeGrenade(IReGameHook_ThrowHeGrenade *chain, entvars_t *pevOwner,
 {
 	Vector vecStartCopy(vecStart), vecVelocityCopy(vecVelocity);
 
-	auto original = [chain, &vecStartCopy, &vecVelocityCopy](int _pevOwner, cell _vecStart, cell _vecVelocity, float _time, int _iTeam, unsigned short _usEvent)
+	auto original = [chain, &vecStartCopy, &vecVelocityCopy](int _pevOwner, amxvector_t _vecStart, amxvector_t _vecVelocity, float _time, int _iTeam, unsigned short _usEvent)
 	{
 		return indexOfPDataAmx(chain->callNext(PEV(_pevOwner), vecStartCopy, vecVelocityCopy, _time, _iTeam, _usEvent));
 	};
@@ -1160,7 +1331,7 @@ CGrenade *ThrowFlashbang(IReGameHook_ThrowFlashbang *chain, entvars_t *pevOwner,
 {
 	Vector vecStartCopy(vecStart), vecVelocityCopy(vecVelocity);
 
-	auto original = [chain, &vecStartCopy, &vecVelocityCopy](int _pevOwner, cell _vecStart, cell _vecVelocity, float _time)
+	auto original = [chain, &vecStartCopy, &vecVelocityCopy](int _pevOwner, amxvector_t _vecStart, amxvector_t _vecVelocity, float _time)
 	{
 		return indexOfPDataAmx(chain->callNext(PEV(_pevOwner), vecStartCopy, vecVelocityCopy, _time));
 	};
@@ -1172,7 +1343,7 @@ CGrenade *ThrowSmokeGrenade(IReGameHook_ThrowSmokeGrenade *chain, entvars_t *pev
 {
 	Vector vecStartCopy(vecStart), vecVelocityCopy(vecVelocity);
 
-	auto original = [chain, &vecStartCopy, &vecVelocityCopy](int _pevOwner, cell _vecStart, cell _vecVelocity, float _time, unsigned short _usEvent)
+	auto original = [chain, &vecStartCopy, &vecVelocityCopy](int _pevOwner, amxvector_t _vecStart, amxvector_t _vecVelocity, float _time, unsigned short _usEvent)
 	{
 		return indexOfPDataAmx(chain->callNext(PEV(_pevOwner), vecStartCopy, vecVelocityCopy, _time, _usEvent));
 	};
@@ -1184,7 +1355,7 @@ CGrenade *PlantBomb(IReGameHook_PlantBomb *chain, entvars_t *pevOwner, Vector &v
 {
 	Vector vecStartCopy(vecStart), vecVelocityCopy(vecVelocity);
 
-	auto original = [chain, &vecStartCopy, &vecVelocityCopy](int _pevOwner, cell _vecStart, cell _vecVelocity)
+	auto original = [chain, &vecStartCopy, &vecVelocityCopy](int _pevOwner, amxvector_t _vecStart, amxvector_t _vecVelocity)
 	{
 		return indexOfPDataAmx(chain->callNext(PEV(_pevOwner), vecStartCopy, vecVelocityCopy));
 	};
@@ -1216,7 +1387,7 @@ bool IsPenetrableEntity(IReGameHook_IsPenetrableEntity *chain, Vector &vecSrc, V
 {
 	Vector vecSrcCopy(vecSrc), vecEndCopy(vecEnd);
 
-	auto original = [chain, &vecSrcCopy, &vecEndCopy](cell _vecSrc, cell _vecEnd, int _pevAttacker, int _pHit)
+	auto original = [chain, &vecSrcCopy, &vecEndCopy](amxvector_t _vecSrc, amxvector_t _vecEnd, int _pevAttacker, int _pHit)
 	{
 		return chain->callNext(vecSrcCopy, vecEndCopy, PEV(_pevAttacker), edictByIndexAmx(_pHit));
 	};
@@ -1298,7 +1469,7 @@ CWeaponBox *CreateWeaponBox(IReGameHook_CreateWeaponBox *chain, CBasePlayerItem
 {
 	Vector vecOriginCopy(origin), vecAnglesCopy(angles), vecVelocityCopy(velocity);
 
-	auto original = [chain, &vecOriginCopy, &vecAnglesCopy, &vecVelocityCopy](int _pItem, int _pPlayerOwner, const char *_modelName, cell _origin, cell _angles, cell _velocity, float _lifeTime, bool _packAmmo)
+	auto original = [chain, &vecOriginCopy, &vecAnglesCopy, &vecVelocityCopy](int _pItem, int _pPlayerOwner, const char *_modelName, amxvector_t _origin, amxvector_t _angles, amxvector_t _velocity, float _lifeTime, bool _packAmmo)
 	{
 		return indexOfPDataAmx(chain->callNext(getPrivate<CBasePlayerItem>(_pItem), getPrivate<CBasePlayer>(_pPlayerOwner), _modelName, vecOriginCopy, vecAnglesCopy, vecVelocityCopy, _lifeTime, _packAmmo));
 	};
@@ -1360,7 +1531,7 @@ void CBaseEntity_FireBullets(IReGameHook_CBaseEntity_FireBullets *chain, CBaseEn
 {
 	Vector vecSrcCopy(vecSrc), vecDirShootingCopy(vecDirShooting), vecSpreadCopy(vecSpread);
 
-	auto original = [chain, &vecSrcCopy, &vecDirShootingCopy, &vecSpreadCopy](int _pEntity, ULONG _cShots, cell _vecSrc, cell _vecDirShooting, cell _vecSpread, float _flDistance, int _iBulletType, int _iTracerFreq, int _iDamage, int _pevAttacker)
+	auto original = [chain, &vecSrcCopy, &vecDirShootingCopy, &vecSpreadCopy](int _pEntity, ULONG _cShots, amxvector_t _vecSrc, amxvector_t _vecDirShooting, amxvector_t _vecSpread, float _flDistance, int _iBulletType, int _iTracerFreq, int _iDamage, int _pevAttacker)
 	{
 		chain->callNext(getPrivate<CBaseEntity>(_pEntity), _cShots, vecSrcCopy, vecDirShootingCopy, vecSpreadCopy, _flDistance, _iBulletType, _iTracerFreq, _iDamage, PEV(_pevAttacker));
 	};
@@ -1372,7 +1543,7 @@ void CBaseEntity_FireBuckshots(IReGameHook_CBaseEntity_FireBuckshots *chain, CBa
 {
 	Vector vecSrcCopy(vecSrc), vecDirShootingCopy(vecDirShooting), vecSpreadCopy(vecSpread);
 
-	auto original = [chain, &vecSrcCopy, &vecDirShootingCopy, &vecSpreadCopy](int _pEntity, ULONG _cShots, cell _vecSrc, cell _vecDirShooting, cell _vecSpread, float _flDistance, int _iTracerFreq, int _iDamage, int _pevAttacker)
+	auto original = [chain, &vecSrcCopy, &vecDirShootingCopy, &vecSpreadCopy](int _pEntity, ULONG _cShots, amxvector_t _vecSrc, amxvector_t _vecDirShooting, amxvector_t _vecSpread, float _flDistance, int _iTracerFreq, int _iDamage, int _pevAttacker)
 	{
 		chain->callNext(getPrivate<CBaseEntity>(_pEntity), _cShots, vecSrcCopy, vecDirShootingCopy, vecSpreadCopy, _flDistance, _iTracerFreq, _iDamage, PEV(_pevAttacker));
 	};
@@ -1384,7 +1555,7 @@ Vector &CBaseEntity_FireBullets3(IReGameHook_CBaseEntity_FireBullets3 *chain, CB
 {
 	Vector vecSrcCopy(vecSrc), vecDirShootingCopy(vecDirShooting);
 
-	auto original = [chain, &vecSrcCopy, &vecDirShootingCopy](int _pEntity, cell _vecSrc, cell _vecDirShooting, float _vecSpread, float _flDistance, int _iPenetration, int _iBulletType, int _iDamage, float _flRangeModifier, int _pevAttacker, bool _bPistol, int _shared_rand) -> Vector&
+	auto original = [chain, &vecSrcCopy, &vecDirShootingCopy](int _pEntity, amxvector_t _vecSrc, amxvector_t _vecDirShooting, float _vecSpread, float _flDistance, int _iPenetration, int _iBulletType, int _iDamage, float _flRangeModifier, int _pevAttacker, bool _bPistol, int _shared_rand) -> Vector&
 	{
 		return chain->callNext(getPrivate<CBaseEntity>(_pEntity), vecSrcCopy, vecDirShootingCopy, _vecSpread, _flDistance, _iPenetration, _iBulletType, _iDamage, _flRangeModifier, PEV(_pevAttacker), _bPistol, _shared_rand);
 	};
@@ -1497,7 +1668,9 @@ void PM_Jump_AMXX(IReGameHook_PM_Jump *chain, int playerIndex)
 {
 	auto original = [chain](int _playerIndex)
 	{
+		g_moveModifiers.PreJump(g_pMove);
 		chain->callNext();
+		g_moveModifiers.PostJump(g_pMove);
 	};
 
 	callVoidForward(RG_PM_Jump, original, playerIndex);
@@ -1557,7 +1730,7 @@ void PM_AirAccelerate_AMXX(IReGameHook_PM_AirAccelerate *chain, vec_t *wishdir,
 {
 	Vector wishdirCopy(wishdir);
 
-	auto original = [chain, &wishdirCopy](cell _wishdir, float _wishspeed, float _accel, int _playerIndex)
+	auto original = [chain, &wishdirCopy](amxvector_t _wishdir, float _wishspeed, float _accel, int _playerIndex)
 	{
 		chain->callNext(wishdirCopy, _wishspeed, _accel);
 	};
@@ -42,22 +42,23 @@ struct retval_t
 	};
 };
 
-inline AType getApiType(int)            { return ATYPE_INTEGER; }
-inline AType getApiType(unsigned)       { return ATYPE_INTEGER; }
-inline AType getApiType(ULONG)          { return ATYPE_INTEGER; }
-inline AType getApiType(float)          { return ATYPE_FLOAT; }
-inline AType getApiType(const char *)   { return ATYPE_STRING; }
-inline AType getApiType(char[])         { return ATYPE_STRING; }
-inline AType getApiType(CBaseEntity *)  { return ATYPE_CLASSPTR; }
-inline AType getApiType(edict_t *)      { return ATYPE_EDICT; }
-inline AType getApiType(entvars_t *)    { return ATYPE_EVARS; }
-inline AType getApiType(bool)           { return ATYPE_BOOL; }
+constexpr AType getApiType(int)            { return ATYPE_INTEGER; }
+constexpr AType getApiType(unsigned)       { return ATYPE_INTEGER; }
+constexpr AType getApiType(ULONG)          { return ATYPE_INTEGER; }
+constexpr AType getApiType(float)          { return ATYPE_FLOAT; }
+constexpr AType getApiType(const char *)   { return ATYPE_STRING; }
+constexpr AType getApiType(char[])         { return ATYPE_STRING; }
+constexpr AType getApiType(CBaseEntity *)  { return ATYPE_CLASSPTR; }
+constexpr AType getApiType(edict_t *)      { return ATYPE_EDICT; }
+constexpr AType getApiType(entvars_t *)    { return ATYPE_EVARS; }
+constexpr AType getApiType(bool)           { return ATYPE_BOOL; }
 inline AType getApiType(Vector)         { return ATYPE_VECTOR; }
-inline AType getApiType(ENTITYINIT)     { return ATYPE_INTEGER; }
-inline AType getApiType(TraceResult*)   { return ATYPE_TRACE; }
+constexpr AType getApiType(ENTITYINIT)     { return ATYPE_INTEGER; }
+constexpr AType getApiType(TraceResult*)   { return ATYPE_TRACE; }
+constexpr AType getApiType(amxvector_t)    { return ATYPE_VECTOR; }
 
 template<typename T>
-inline AType getApiType(T *) { return ATYPE_INTEGER; }
+constexpr AType getApiType(T *) { return ATYPE_INTEGER; }
 
 inline bool hasStringArgs() { return false; }
 
@@ -74,41 +75,51 @@ bool hasStringArgs(T, f_args... args)
 
 #define MAX_HOOKCHAIN_ARGS 12u
 
+// argument descriptor of hookchain, the address is taken from the arguments tuple only when a native asks for it
+struct hookarg_t
+{
+	AType type;
+	size_t (*handle)(void *args);
+};
+
+template <typename tuple_t, size_t current>
+size_t getHookArgHandle(void *args)
+{
+	return (size_t)&std::get<current>(*(tuple_t *)args);
+}
+
+// static table of argument descriptors per hookchain signature
+template <typename tuple_t, size_t ...Is>
+const hookarg_t *getHookArgs(std::index_sequence<Is...>)
+{
+	static constexpr hookarg_t args[] = {
+		{ getApiType(typename std::decay<std::tuple_element_t<Is, tuple_t>>::type()), &getHookArgHandle<tuple_t, Is> }...,
+		{ ATYPE_INTEGER, nullptr } // to avoid an empty array
+	};
+
+	return args;
+}
+
 struct hookctx_t
 {
-	template<typename ...t_args>
-	hookctx_t(size_t arg_count, t_args&&... args)
-	{
-		if (hasStringArgs(args...)) {
-			tempstrings_used = 0;
-		}
+	hookctx_t() {}
 
-		args_count = min(arg_count, MAX_HOOKCHAIN_ARGS);
-		setArgs(std::forward_as_tuple(args...));
+	template<typename tuple_t>
+	hookctx_t(tuple_t &t)
+	{
+		args_count = std::tuple_size<tuple_t>::value;
+		args_table = getHookArgs<tuple_t>(std::make_index_sequence<std::tuple_size<tuple_t>::value>{});
+		args_tuple = &t;
 	}
 
-	template <size_t current = 0,
-			typename tuple_t,
-			size_t size = std::tuple_size<typename std::decay<tuple_t>::type>::value,
-			std::enable_if_t<current >= size>* = nullptr> // if current >= size
-	void setArgs(tuple_t &&t)
+	AType getArgType(size_t number) const
 	{
+		return args_table[number].type;
 	}
 
-	template <size_t current = 0,
-			typename tuple_t,
-			size_t size = std::tuple_size<typename std::decay<tuple_t>::type>::value,
-			std::enable_if_t<current < size>* = nullptr> // if current < size
-	void setArgs(tuple_t &&t)
+	size_t getArgHandle(size_t number) const
 	{
-		// current iteration
-		if (current < MAX_HOOKCHAIN_ARGS)
-		{
-			auto &arg = std::get<current>(std::forward<tuple_t>(t));
-			args[current].handle = (size_t)&arg;
-			args[current].type   = getApiType(arg);
-			setArgs<current + 1>(std::forward<tuple_t>(t)); // call next
-		}
+		return args_table[number].handle(args_tuple);
 	}
 
 	void reset(AType ret_type = ATYPE_INTEGER)
@@ -117,16 +128,9 @@ struct hookctx_t
 		retVal.type = ret_type;
 	}
 
-	char* get_temp_string(AMX* amx)
+	char* get_temp_string(size_t size)
 	{
-		auto ptr = s_temp_strings.push(amx);
-		if (likely(ptr)) {
-			tempstrings_used++;
-			return ptr;
-		}
-
-		static char fatalErr[] = "<reapi error>";
-		return fatalErr;
+		return s_temp_strings.push(size);
 	}
 
 	void SetId(int id) { index = id; }
@@ -134,26 +138,305 @@ struct hookctx_t
 
 	void clear_temp_strings() const
 	{
-		s_temp_strings.pop(tempstrings_used);
+		s_temp_strings.release(tempstrings_mark);
 	}
 
 	int index                       = 0;
 	retval_t retVal                 = {false,ATYPE_INTEGER};
-	size_t tempstrings_used         = 0;
-
-	struct args_t
-	{
-		size_t handle;
-		AType  type;
-	};
+	CTempStrings::mark_t tempstrings_mark = {};
 
 	size_t args_count               = 0;
-	args_t args[MAX_HOOKCHAIN_ARGS] = {};
+	const hookarg_t *args_table     = nullptr;
+	void *args_tuple                = nullptr;
 	static CTempStrings s_temp_strings;
 };
 
 extern hookctx_t* g_hookCtx;
 
+// state of the arguments pushed onto the AMX stack of a hookchain handler
+struct amxpush_t
+{
+	amxpush_t(AMX *_amx) : amx(_amx), error(AMX_ERR_NONE), hea(_amx->hea), stk(_amx->stk), vectors(0) {}
+
+	// a copy left unchanged by the handler doesn't overwrite the vector, it could be set by SetHookChainArg
+	void copyBack() const
+	{
+		for (size_t i = 0; i < vectors; i++) {
+			if (Q_memcmp(copyback[i].phys, &copyback[i].pushed, sizeof(Vector)) != 0)
+				Q_memcpy(copyback[i].vec, copyback[i].phys, sizeof(Vector));
+		}
+	}
+
+	// executes the handler with the pushed arguments and restores the heap of plugin
+	cell exec(CAmxxHookBase *fwd);
+
+	AMX *amx;
+	int error;
+	cell hea, stk;
+
+	struct vector_t
+	{
+		Vector *vec;
+		cell *phys;
+		Vector pushed;
+	};
+
+	size_t vectors;
+	vector_t copyback[MAX_HOOKCHAIN_ARGS];
+};
+
+inline void amxPushCell(amxpush_t &ctx, cell value)
+{
+	int err = g_amxxapi.amx_Push(ctx.amx, value);
+	if (unlikely(err != AMX_ERR_NONE))
+		ctx.error = err;
+}
+
+inline void amxPushArg(amxpush_t &ctx, float value)
+{
+	amxPushCell(ctx, amx_ftoc(value));
+}
+
+inline void amxPushArg(amxpush_t &ctx, const char *value)
+{
+	// widen once right into the heap of handler, the same way as amx_SetString does for unpacked strings
+	size_t len = Q_strlen(value);
+	cell amx_addr, *phys;
+	int err = g_amxxapi.amx_Allot(ctx.amx, len + 1, &amx_addr, &phys);
+	if (unlikely(err != AMX_ERR_NONE)) {
+		ctx.error = err;
+		return;
+	}
+
+	for (size_t i = 0; i < len; i++)
+		phys[i] = (cell)value[i];
+
+	phys[len] = '\0';
+	amxPushCell(ctx, amx_addr);
+}
+
+inline void amxPushArg(amxpush_t &ctx, char *value)
+{
+	amxPushArg(ctx, (const char *)value);
+}
+
+inline void amxPushArray(amxpush_t &ctx, const cell *data, size_t count)
+{
+	cell amx_addr, *phys;
+	int err = g_amxxapi.amx_Allot(ctx.amx, count ? count : 1, &amx_addr, &phys);
+	if (unlikely(err != AMX_ERR_NONE)) {
+		ctx.error = err;
+		return;
+	}
+
+	Q_memcpy(phys, data, count * sizeof(cell));
+	amxPushCell(ctx, amx_addr);
+}
+
+inline void amxPushArg(amxpush_t &ctx, const amxvector_t &value)
+{
+	cell amx_addr, *phys;
+	int err = g_amxxapi.amx_Allot(ctx.amx, 3, &amx_addr, &phys);
+	if (unlikely(err != AMX_ERR_NONE)) {
+		ctx.error = err;
+		return;
+	}
+
+	Q_memcpy(phys, value.vec, sizeof(Vector));
+	ctx.copyback[ctx.vectors++] = { value.vec, phys, *value.vec };
+	amxPushCell(ctx, amx_addr);
+}
+
+template <typename T>
+inline void amxPushArg(amxpush_t &ctx, T *value)
+{
+	amxPushCell(ctx, (cell)value);
+}
+
+template <typename T, std::enable_if_t<std::is_integral<T>::value || std::is_enum<T>::value>* = nullptr>
+inline void amxPushArg(amxpush_t &ctx, T value)
+{
+	amxPushCell(ctx, (cell)value);
+}
+
+inline void amxPushArgs(amxpush_t &ctx)
+{
+}
+
+// AMX takes the parameters in reverse order
+template <typename T, typename ...f_args>
+inline void amxPushArgs(amxpush_t &ctx, T &&arg, f_args&&... args)
+{
+	amxPushArgs(ctx, std::forward<f_args &&>(args)...);
+	amxPushArg(ctx, arg);
+}
+
+// vector arguments of the fallback through ExecuteForward, copied back the same way as amxpush_t does
+struct fwdvectors_t
+{
+	fwdvectors_t() : vectors(0) {}
+
+	void copyBack() const
+	{
+		for (size_t i = 0; i < vectors; i++) {
+			if (Q_memcmp(&copyback[i].copy, &copyback[i].pushed, sizeof(Vector)) != 0)
+				*copyback[i].vec = copyback[i].copy;
+		}
+	}
+
+	struct vector_t
+	{
+		Vector *vec;
+		Vector copy;
+		Vector pushed;
+	};
+
+	size_t vectors;
+	vector_t copyback[MAX_HOOKCHAIN_ARGS];
+};
+
+// parameter for the fallback through ExecuteForward
+inline cell toFwdArg(fwdvectors_t &ctx, const amxvector_t &value)
+{
+	auto &arg = ctx.copyback[ctx.vectors++];
+	arg.vec = value.vec;
+	arg.copy = arg.pushed = *value.vec;
+	return g_amxxapi.PrepareCellArrayA(reinterpret_cast<cell *>(&arg.copy), 3, true);
+}
+
+template <typename T, std::enable_if_t<!std::is_same<std::decay_t<T>, amxvector_t>::value>* = nullptr>
+inline T &&toFwdArg(fwdvectors_t &ctx, T &&value)
+{
+	return std::forward<T>(value);
+}
+
+// Calls the handler of hookchain straight through amx_Exec.
+// Plugins running under the debugger still go through ExecuteForward, it keeps track of the call frames for the backtraces.
+template <typename ...f_args>
+cell executeHookForward(CAmxxHookBase *fwd, f_args&&... args)
+{
+	g_metrics.AmxCall();
+
+	if (unlikely(!fwd->CanExecDirect())) {
+		fwdvectors_t vectors;
+		cell ret = g_amxxapi.ExecuteForward(fwd->GetFwdIndex(), toFwdArg(vectors, std::forward<f_args &&>(args))...);
+		vectors.copyBack();
+		return ret;
+	}
+
+	amxpush_t ctx(fwd->GetAmx());
+	amxPushArgs(ctx, std::forward<f_args &&>(args)...);
+	return ctx.exec(fwd);
+}
+
+// Post handlers registered as deferred.
+// Arguments of the call are copied by value into the buffer of current frame
+// and the handlers are executed in a batch at the start of next frame.
+class CDeferredHooks
+{
+public:
+	template <typename ...f_args>
+	void Push(CAmxxHookBase *fwd, const retval_t *retVal, f_args&&... args)
+	{
+		static_assert(sizeof...(args) <= MAX_HOOKCHAIN_ARGS, "too many arguments of deferred hookchain");
+
+		size_t start = m_buffer.size();
+		m_buffer.resize(start + rec_args);
+
+		cell *rec = &m_buffer[start];
+		rec[rec_handle]  = fwd->GetIndex();
+		rec[rec_argc]    = sizeof...(args);
+		rec[rec_retset]  = FALSE;
+		rec[rec_rettype] = ATYPE_INTEGER;
+		rec[rec_retval]  = 0;
+
+		if (retVal)
+		{
+			rec[rec_rettype] = retVal->type;
+
+			// only plain values outlive the frame
+			if (retVal->set && (retVal->type == ATYPE_INTEGER || retVal->type == ATYPE_FLOAT || retVal->type == ATYPE_BOOL)) {
+				rec[rec_retset] = TRUE;
+				rec[rec_retval] = retVal->_integer;
+			}
+		}
+
+		PutArgs(args...);
+		m_buffer[start + rec_size] = m_buffer.size() - start;
+	}
+
+	void Flush();
+	void Clear();
+
+private:
+	enum rec_e { rec_handle, rec_size, rec_argc, rec_retset, rec_rettype, rec_retval, rec_args };
+	enum arg_e { arg_cell, arg_string, arg_vector };
+
+	void PutCell(cell value)
+	{
+		m_buffer.push_back(arg_cell);
+		m_buffer.push_back(value);
+	}
+
+	void PutArg(float value)
+	{
+		PutCell(amx_ftoc(value));
+	}
+
+	void PutArg(const char *value)
+	{
+		size_t len = Q_strlen(value);
+		size_t start = m_buffer.size();
+
+		m_buffer.resize(start + 2 + (len + sizeof(cell)) / sizeof(cell));
+		m_buffer[start] = arg_string;
+		m_buffer[start + 1] = len;
+		Q_memcpy(&m_buffer[start + 2], value, len + 1);
+	}
+
+	void PutArg(char *value)
+	{
+		PutArg((const char *)value);
+	}
+
+	void PutArg(const amxvector_t &value)
+	{
+		m_buffer.push_back(arg_vector);
+		m_buffer.insert(m_buffer.end(), (cell *)value.vec, (cell *)value.vec + 3);
+	}
+
+	// pointers aren't valid anymore at the next frame
+	template <typename T>
+	void PutArg(T *value)
+	{
+		PutCell(0);
+	}
+
+	template <typename T, std::enable_if_t<std::is_integral<T>::value || std::is_enum<T>::value>* = nullptr>
+	void PutArg(T value)
+	{
+		PutCell((cell)value);
+	}
+
+	void PutArgs()
+	{
+	}
+
+	template <typename T, typename ...f_args>
+	void PutArgs(T &&arg, f_args&&... args)
+	{
+		PutArg(arg);
+		PutArgs(args...);
+	}
+
+	void Execute(cell *rec);
+
+	std::vector<cell> m_buffer;
+	std::vector<cell> m_delivering;
+};
+
+extern CDeferredHooks g_deferredHooks;
+
 template <typename original_t, typename ...f_args>
 NOINLINE void DLLEXPORT _callVoidForward(hook_t* hook, original_t original, f_args&&... args)
 {
@@ -168,7 +451,7 @@ NOINLINE void DLLEXPORT _callVoidForward(hook_t* hook, original_t original, f_ar
 		if (likely(fwd->GetState() == FSTATE_ENABLED))
 		{
 			hookCtx->SetId(fwd->GetIndex()); // set current handler hook
-			auto ret = g_amxxapi.ExecuteForward(fwd->GetFwdIndex(), std::forward<f_args &&>(args)...);
+			auto ret = executeHookForward(fwd, std::forward<f_args &&>(args)...);
 			hookCtx->ResetId();
 
 			if (unlikely(ret == HC_BREAK)) {
@@ -191,8 +474,14 @@ NOINLINE void DLLEXPORT _callVoidForward(hook_t* hook, original_t original, f_ar
 	{
 		if (likely(fwd->GetState() == FSTATE_ENABLED))
 		{
+			if (unlikely(fwd->GetMode() != FMODE_INPLACE)) {
+				if (fwd->GetMode() == FMODE_DEFERRED)
+					g_deferredHooks.Push(fwd, nullptr, std::forward<f_args &&>(args)...);
+				continue;
+			}
+
 			hookCtx->SetId(fwd->GetIndex()); // set current handler hook
-			auto ret = g_amxxapi.ExecuteForward(fwd->GetFwdIndex(), std::forward<f_args &&>(args)...);
+			auto ret = executeHookForward(fwd, std::forward<f_args &&>(args)...);
 			hookCtx->ResetId();
 
 			if (unlikely(ret == HC_BREAK))
@@ -206,11 +495,19 @@ NOINLINE void DLLEXPORT _callVoidForward(hook_t* hook, original_t original, f_ar
 template <typename original_t, typename ...f_args>
 void callVoidForward(size_t func, original_t original, f_args&&... args)
 {
-	hookctx_t hookCtx(sizeof...(args), args...);
+	auto args_tuple = std::forward_as_tuple(args...);
+	hookctx_t hookCtx(args_tuple);
 	hookctx_t* save = g_hookCtx;
 
+	if (hasStringArgs(args...)) {
+		hookCtx.tempstrings_mark = hookctx_t::s_temp_strings.mark();
+	}
+
+	hook_t *hook = g_hookManager.getHookFast(func);
+	CHookTimer timer(hook);
+
 	g_hookCtx = &hookCtx;
-	_callVoidForward(g_hookManager.getHookFast(func), original, args...);
+	_callVoidForward(hook, original, args...);
 	g_hookCtx = save;
 
 	if (hasStringArgs(args...)) {
@@ -235,7 +532,7 @@ NOINLINE R DLLEXPORT _callForward(hook_t* hook, original_t original, f_args&&...
 		if (likely(fwd->GetState() == FSTATE_ENABLED))
 		{
 			hookCtx->SetId(fwd->GetIndex()); // set current handler hook
-			auto ret = g_amxxapi.ExecuteForward(fwd->GetFwdIndex(), std::forward<f_args &&>(args)...);
+			auto ret = executeHookForward(fwd, std::forward<f_args &&>(args)...);
 			hookCtx->ResetId();
 
 			if (unlikely(ret != HC_SUPERCEDE && ret != HC_BREAK)) {
@@ -286,8 +583,14 @@ NOINLINE R DLLEXPORT _callForward(hook_t* hook, original_t original, f_args&&...
 	{
 		if (likely(fwd->GetState() == FSTATE_ENABLED))
 		{
+			if (unlikely(fwd->GetMode() != FMODE_INPLACE)) {
+				if (fwd->GetMode() == FMODE_DEFERRED)
+					g_deferredHooks.Push(fwd, &hookCtx->retVal, std::forward<f_args &&>(args)...);
+				continue;
+			}
+
 			hookCtx->SetId(fwd->GetIndex()); // set current handler hook
-			auto ret = g_amxxapi.ExecuteForward(fwd->GetFwdIndex(), std::forward<f_args &&>(args)...);
+			auto ret = executeHookForward(fwd, std::forward<f_args &&>(args)...);
 			hookCtx->ResetId();
 
 			if (unlikely(ret == HC_BREAK))
@@ -306,11 +609,19 @@ NOINLINE R DLLEXPORT _callForward(hook_t* hook, original_t original, f_args&&...
 template <typename R, typename original_t, typename ...f_args>
 R callForward(size_t func, original_t original, f_args&&... args)
 {
-	hookctx_t hookCtx(sizeof...(args), args...);
+	auto args_tuple = std::forward_as_tuple(args...);
+	hookctx_t hookCtx(args_tuple);
 	hookctx_t* save = g_hookCtx;
 
+	if (hasStringArgs(args...)) {
+		hookCtx.tempstrings_mark = hookctx_t::s_temp_strings.mark();
+	}
+
+	hook_t *hook = g_hookManager.getHookFast(func);
+	CHookTimer timer(hook);
+
 	g_hookCtx = &hookCtx;
-	R ret = _callForward<R>(g_hookManager.getHookFast(func), original, args...);
+	R ret = _callForward<R>(hook, original, args...);
 	g_hookCtx = save;
 
 	if (hasStringArgs(args...)) {
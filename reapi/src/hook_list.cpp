@@ -348,6 +348,19 @@ void hook_t::clear()
 			delete h;
 		post.clear();
 
-		unregisterHookchain();
+		if (!users)
+			unregisterHookchain();
 	}
 }
+
+void hook_t::acquire()
+{
+	if (!users++ && !pre.size() && !post.size())
+		registerHookchain();
+}
+
+void hook_t::release()
+{
+	if (!--users && !pre.size() && !post.size())
+		unregisterHookchain();
+}
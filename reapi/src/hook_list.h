@@ -24,7 +24,15 @@ struct hook_t
 
 	void clear();
 
+	// keep re* API hook registered for the module own needs
+	void acquire();
+	void release();
+
 	bool wasCalled;
+	size_t users;                           // module own users of the hookchain
+
+	uint64 calls;                           // dispatch statistics for the metrics
+	double time;
 };
 
 extern hook_t hooklist_engine[];
@@ -2,11 +2,11 @@
 
 CHookManager g_hookManager;
 
-int CHookManager::addHandler(AMX *amx, int func, const char *funcname, int forward, bool post) const
+int CHookManager::addHandler(AMX *amx, int func, const char *funcname, int forward, bool post, fwdmode mode) const
 {
 	auto hook = m_hooklist.getHookSafe(func);
 
-	if (!hook->post.size() && !hook->pre.size())
+	if (!hook->post.size() && !hook->pre.size() && !hook->users)
 	{
 		// API hookchain
 		hook->registerHookchain();
@@ -16,7 +16,13 @@ int CHookManager::addHandler(AMX *amx, int func, const char *funcname, int forwa
 	int i = func * MAX_HOOK_FORWARDS + dest.size() + 1;
 	int index = post ? -i : i; // use unsigned ids for post hooks
 
-	dest.push_back(new CAmxxHookBase(amx, funcname, forward, index));
+	auto handler = new CAmxxHookBase(amx, funcname, forward, index);
+
+	// plugins under the debugger get deferred handlers called in place
+	if (mode != FMODE_DEFERRED || handler->CanExecDirect())
+		handler->SetMode(mode);
+
+	dest.push_back(handler);
 	return index;
 }
 
@@ -7,7 +7,7 @@ class CHookManager
 {
 public:
 	void Clear() const;
-	cell addHandler(AMX *amx, int func, const char *funcname, int forward, bool post) const;
+	cell addHandler(AMX *amx, int func, const char *funcname, int forward, bool post, fwdmode mode = FMODE_INPLACE) const;
 	hook_t *getHook(size_t func) const;
 	CAmxxHookBase *getAmxxHook(cell hook) const;
 
@@ -0,0 +1,154 @@
+#include "precompiled.h"
+
+CJobScheduler g_jobScheduler;
+
+inline int ElapsedMicroseconds(uint64 start)
+{
+	return int(Sys_MicroTime() - start);
+}
+
+int CJobScheduler::Add(AMX *amx, const char *funcname, const cell *data, size_t size, int priority, int budget)
+{
+	int fwdid = g_amxxapi.RegisterSPForwardByName(amx, funcname, FP_CELL, FP_ARRAY, FP_CELL, FP_DONE);
+	if (fwdid == -1)
+		return 0;
+
+	auto job = new job_t;
+	job->id = ++m_lastId;
+	job->fwdid = fwdid;
+	job->priority = priority;
+	job->budget = budget;
+	job->removed = false;
+
+	// keep one cell at least to pass the array to the callback
+	job->data.assign(data, data + size);
+	job->data.resize(max(size, size_t(1)));
+	job->size = size;
+
+	// the list can't be changed while the jobs are running
+	if (m_running) {
+		m_pending.push_back(job);
+		return job->id;
+	}
+
+	// the jobs of the same priority run in the order of adding
+	auto iter = std::upper_bound(m_jobs.begin(), m_jobs.end(), job, [](const job_t *a, const job_t *b) { return a->priority > b->priority; });
+	m_jobs.insert(iter, job);
+
+	return job->id;
+}
+
+CJobScheduler::job_t *CJobScheduler::Find(int id) const
+{
+	for (auto job : m_jobs)
+	{
+		if (job->id == id)
+			return job->removed ? nullptr : job;
+	}
+
+	for (auto job : m_pending)
+	{
+		if (job->id == id)
+			return job->removed ? nullptr : job;
+	}
+
+	return nullptr;
+}
+
+bool CJobScheduler::IsValid(int id) const
+{
+	return Find(id) != nullptr;
+}
+
+bool CJobScheduler::Remove(int id)
+{
+	job_t *job = Find(id);
+	if (!job)
+		return false;
+
+	job->removed = true;
+
+	// the removed jobs are collected after the run
+	if (!m_running)
+	{
+		m_jobs.erase(std::find(m_jobs.begin(), m_jobs.end(), job));
+		Free(job);
+	}
+
+	return true;
+}
+
+void CJobScheduler::Free(job_t *job)
+{
+	g_amxxapi.UnregisterSPForward(job->fwdid);
+	delete job;
+}
+
+void CJobScheduler::Clear()
+{
+	for (auto job : m_jobs)
+		Free(job);
+
+	for (auto job : m_pending)
+		Free(job);
+
+	m_jobs.clear();
+	m_pending.clear();
+}
+
+void CJobScheduler::Run()
+{
+	if (m_jobs.empty())
+		return;
+
+	m_running = true;
+	auto frameStart = Sys_MicroTime();
+
+	for (auto job : m_jobs)
+	{
+		if (job->removed)
+			continue;
+
+		// the slice is called once at least, so a too long step overruns the budget
+		auto start = Sys_MicroTime();
+		do
+		{
+			cell ret = g_amxxapi.ExecuteForward(job->fwdid, job->id, g_amxxapi.PrepareCellArrayA(job->data.data(), job->data.size(), true), job->size);
+
+			if (ret != JOB_CONTINUE)
+				job->removed = true;
+		}
+		while (!job->removed && ElapsedMicroseconds(start) < job->budget);
+
+		if (m_frameBudget && ElapsedMicroseconds(frameStart) >= m_frameBudget)
+			break;
+	}
+
+	m_running = false;
+
+	auto iter = m_jobs.begin();
+	while (iter != m_jobs.end())
+	{
+		if ((*iter)->removed) {
+			Free(*iter);
+			iter = m_jobs.erase(iter);
+		}
+		else
+			iter++;
+	}
+
+	// the jobs added by the callbacks start from next frame
+	std::vector<job_t *> pending;
+	pending.swap(m_pending);
+
+	for (auto job : pending)
+	{
+		if (job->removed) {
+			Free(job);
+			continue;
+		}
+
+		auto where = std::upper_bound(m_jobs.begin(), m_jobs.end(), job, [](const job_t *a, const job_t *b) { return a->priority > b->priority; });
+		m_jobs.insert(where, job);
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+// return value of the job callback
+enum JobResult
+{
+	JOB_DONE = 0,       // the job is finished and removed
+	JOB_CONTINUE,       // call the job again, in this or next frame
+};
+
+// Cooperative scheduler of the plugin jobs, run at the start of each frame.
+// The job callback does a small step of work and is called again while
+// the time budget of the job for the frame lasts, the rest carries over to next frame.
+class CJobScheduler
+{
+public:
+	int Add(AMX *amx, const char *funcname, const cell *data, size_t size, int priority, int budget);
+	bool Remove(int id);
+	bool IsValid(int id) const;
+	void Run();
+	void Clear();
+
+	// total time of the jobs per frame, 0 is unlimited
+	void SetFrameBudget(int budget) { m_frameBudget = budget; }
+
+private:
+	struct job_t
+	{
+		int id;
+		int fwdid;
+		int priority;
+		int budget;         // microseconds per frame
+		bool removed;
+		size_t size;        // size of the plugin data
+		std::vector<cell> data;
+	};
+
+	job_t *Find(int id) const;
+	void Free(job_t *job);
+
+	std::vector<job_t *> m_jobs;    // sorted by priority, the highest first
+	std::vector<job_t *> m_pending; // added while the jobs are running
+	int m_lastId = 0;
+	int m_frameBudget = 0;
+	bool m_running = false;
+};
+
+extern CJobScheduler g_jobScheduler;
@@ -0,0 +1,272 @@
+#include "precompiled.h"
+
+CLogTap g_logTap;
+
+bool MatchWildcard(const char *pattern, const char *str, size_t len)
+{
+	const char *star = nullptr, *resume = nullptr, *end = str + len;
+
+	while (str < end)
+	{
+		if (*pattern == '*') {
+			star = pattern++;
+			resume = str;
+		}
+		else if (*pattern == '?' || *pattern == *str) {
+			pattern++;
+			str++;
+		}
+		else if (star) {
+			// let the last star take one more char
+			pattern = star + 1;
+			str = ++resume;
+		}
+		else
+			return false;
+	}
+
+	while (*pattern == '*')
+		pattern++;
+
+	return *pattern == '\0';
+}
+
+bool CLogTap::Start(const char *path, size_t maxSize, size_t maxFiles)
+{
+	Stop();
+
+	m_file = fopen(path, "ab");
+	if (!m_file)
+		return false;
+
+	fseek(m_file, 0, SEEK_END);
+	m_fileSize = ftell(m_file);
+
+	m_path = path;
+	m_maxSize = maxSize;
+	m_maxFiles = maxFiles;
+
+	m_ring.resize(RING_SIZE);
+	m_head = m_tail = 0;
+	m_dropped = 0;
+	m_stop = false;
+	m_line.clear();
+
+	if (!m_thread.Start<CLogTap, &CLogTap::WriterLoop>(this)) {
+		fclose(m_file);
+		m_file = nullptr;
+		return false;
+	}
+
+	if (!m_active) {
+		g_hookManager.getHook(RH_Con_Printf)->acquire();
+		m_active = true;
+	}
+
+	return true;
+}
+
+void CLogTap::Stop()
+{
+	if (!m_thread.IsRunning())
+		return;
+
+	// the unfinished line is written as is
+	FlushLine();
+
+	// the writer drains the ring before the exit
+	m_stop = true;
+	m_thread.Join();
+
+	if (m_file) {
+		fclose(m_file);
+		m_file = nullptr;
+	}
+
+	if (m_active) {
+		g_hookManager.getHook(RH_Con_Printf)->release();
+		m_active = false;
+	}
+}
+
+void CLogTap::AddFilter(const char *pattern, bool exclude)
+{
+	for (auto &filter : m_filters)
+	{
+		if (filter.exclude == exclude && filter.pattern == pattern)
+			return;
+	}
+
+	m_filters.push_back({ pattern, exclude });
+}
+
+void CLogTap::ClearFilters()
+{
+	m_filters.clear();
+}
+
+bool CLogTap::PassFilters(const char *line, size_t len) const
+{
+	// the trailing newline isn't matched
+	if (len > 0 && line[len - 1] == '\n')
+		len--;
+
+	bool hasIncludes = false, included = false;
+
+	for (auto &filter : m_filters)
+	{
+		if (filter.exclude) {
+			if (MatchWildcard(filter.pattern.c_str(), line, len))
+				return false;
+
+			continue;
+		}
+
+		// with include filters the line has to match one of them
+		hasIncludes = true;
+
+		if (!included && MatchWildcard(filter.pattern.c_str(), line, len))
+			included = true;
+	}
+
+	return !hasIncludes || included;
+}
+
+void CLogTap::Push(const char *text)
+{
+	if (!m_active)
+		return;
+
+	// the engine and the plugins often print a line by several calls
+	while (*text)
+	{
+		const char *newline = strchr(text, '\n');
+		size_t len = newline ? newline - text + 1 : strlen(text);
+
+		if (m_line.empty() && newline) {
+			PushLine(text, len);
+		}
+		else {
+			m_line.append(text, min(len, MAX_LINE - min(m_line.size(), MAX_LINE)));
+
+			if (newline) {
+				// keep the newline of the cut line
+				if (m_line.back() != '\n')
+					m_line.back() = '\n';
+
+				FlushLine();
+			}
+		}
+
+		text += len;
+	}
+}
+
+void CLogTap::FlushLine()
+{
+	if (m_line.empty())
+		return;
+
+	PushLine(m_line.c_str(), m_line.size());
+	m_line.clear();
+}
+
+void CLogTap::PushLine(const char *line, size_t len)
+{
+	if (!PassFilters(line, len))
+		return;
+
+	size_t head = m_head.load(std::memory_order_relaxed);
+	size_t tail = m_tail.load(std::memory_order_acquire);
+
+	// the writer is behind, don't wait for it
+	if (len > RING_SIZE - (head - tail)) {
+		m_dropped++;
+		return;
+	}
+
+	size_t offset = head % RING_SIZE;
+	size_t part = min(len, RING_SIZE - offset);
+
+	Q_memcpy(&m_ring[offset], line, part);
+	Q_memcpy(&m_ring[0], line + part, len - part);
+
+	m_head.store(head + len, std::memory_order_release);
+}
+
+void CLogTap::Write(const char *data, size_t size)
+{
+	fwrite(data, 1, size, m_file);
+	m_fileSize += size;
+}
+
+void CLogTap::Rotate()
+{
+	fclose(m_file);
+
+	// log.N-1 -> log.N, ..., log -> log.1
+	char from[512], to[512];
+	for (size_t i = m_maxFiles; i > 0; i--)
+	{
+		if (i > 1)
+			Q_snprintf(from, sizeof(from), "%s.%u", m_path.c_str(), i - 1);
+		else
+			Q_snprintf(from, sizeof(from), "%s", m_path.c_str());
+
+		Q_snprintf(to, sizeof(to), "%s.%u", m_path.c_str(), i);
+
+		remove(to);
+		rename(from, to);
+	}
+
+	// without the backups the file starts over
+	m_file = fopen(m_path.c_str(), "wb");
+	m_fileSize = 0;
+}
+
+void CLogTap::WriterLoop()
+{
+	while (true)
+	{
+		// the stop flag is read before the ring to drain the last lines
+		bool stop = m_stop;
+
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		size_t head = m_head.load(std::memory_order_acquire);
+
+		if (head == tail)
+		{
+			if (stop)
+				break;
+
+			Sys_Sleep(10);
+			continue;
+		}
+
+		if (!m_file) {
+			// can't write, skip the lines
+			m_tail.store(head, std::memory_order_release);
+			continue;
+		}
+
+		size_t dropped = m_dropped.exchange(0);
+		if (dropped) {
+			char note[64];
+			Write(note, Q_snprintf(note, sizeof(note), "[log tap] %u lines dropped\n", dropped));
+		}
+
+		size_t offset = tail % RING_SIZE;
+		size_t size = head - tail;
+		size_t part = min(size, RING_SIZE - offset);
+
+		// the data may wrap around the end of the ring
+		Write(&m_ring[offset], part);
+		Write(&m_ring[0], size - part);
+		m_tail.store(head, std::memory_order_release);
+
+		fflush(m_file);
+
+		if (m_maxSize && m_fileSize >= m_maxSize)
+			Rotate();
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+// Copy of the console output written to a rotating file by a background thread.
+// The output is joined into whole lines, filtered on the game thread and passed through
+// a lock-free single producer, single consumer ring buffer, the game thread never waits for the disk.
+class CLogTap
+{
+public:
+	bool Start(const char *path, size_t maxSize, size_t maxFiles);
+	void Stop();
+	bool IsActive() const { return m_active; }
+
+	void AddFilter(const char *pattern, bool exclude);
+	void ClearFilters();
+
+	// game thread only, the text may hold a part of a line or several lines
+	void Push(const char *text);
+
+private:
+	bool PassFilters(const char *line, size_t len) const;
+	void PushLine(const char *line, size_t len);
+	void FlushLine();
+
+	void WriterLoop();
+	void Write(const char *data, size_t size);
+	void Rotate();
+
+	static const size_t RING_SIZE = 1024 * 1024;
+	static const size_t MAX_LINE = 4096;  // a longer unfinished line is cut
+
+	struct filter_t
+	{
+		std::string pattern;    // * and ? wildcards
+		bool exclude;
+	};
+
+	std::vector<filter_t> m_filters;
+	bool m_active = false;
+	std::string m_line;     // the start of the line waiting for the newline
+
+	std::vector<char> m_ring;
+	std::atomic<size_t> m_head { 0 };   // moved by the game thread
+	std::atomic<size_t> m_tail { 0 };   // moved by the writer thread
+	std::atomic<size_t> m_dropped { 0 };
+	std::atomic<bool> m_stop { false };
+	CThread m_thread;
+
+	// used by the writer thread
+	std::string m_path;
+	size_t m_maxSize = 0;
+	size_t m_maxFiles = 0;
+	size_t m_fileSize = 0;
+	FILE *m_file = nullptr;
+};
+
+extern CLogTap g_logTap;
+
+bool MatchWildcard(const char *pattern, const char *str, size_t len);
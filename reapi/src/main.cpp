@@ -22,6 +22,9 @@ void OnAmxxAttach()
 {
 	// initialize API
 	api_cfg.Init();
+	CVAR_REGISTER(&g_cvarDirectCalls);
+	g_precacheRegistry.Init();
+	g_entityInitCache.Init();
 	g_pEdicts = g_engfuncs.pfnPEntityOfEntIndex(0);
 
 	// If AMXX_Attach been called in a first the event Spawn
@@ -41,8 +44,20 @@ bool OnMetaAttach()
 void OnMetaDetach()
 {
 	// clear all hooks?
+	g_deferredHooks.Clear();
+	g_thinkBatch.Clear();
+	g_moveModifiers.Clear();
+	g_voiceMatrix.Clear();
+	g_jobScheduler.Clear();
+	g_workerPool.Shutdown();
+	g_metrics.Stop();
+	g_fileIOPool.Shutdown();
+	g_logTap.Stop();
+	g_precacheRegistry.Shutdown();
+	g_entityInitCache.Shutdown();
+	g_entityPools.Clear();
 	g_hookManager.Clear();
-	g_queryFileManager.Clear();
+	g_queryFileManager.Shutdown();
 
 	if (api_cfg.hasVTC()) {
 		g_pVoiceTranscoderApi->OnClientStartSpeak() -= OnClientStartSpeak;
@@ -67,6 +82,22 @@ void ServerDeactivate_Post()
 {
 	g_pEdicts = nullptr;
 	api_cfg.ServerDeactivate();
+	g_deferredHooks.Clear();
+	g_thinkBatch.Clear();
+	g_moveModifiers.Clear();
+	g_voiceMatrix.Clear();
+	g_playerHistory.Clear();
+	g_entityPools.Clear();
+	g_entitySnapshots.Clear();
+	g_boneCache.Clear();
+	g_entityTemplates.Clear();
+	g_playerStates.Clear();
+	g_damageGrid.Clear();
+	g_precacheRegistry.Clear();
+	g_entityInitCache.Clear();
+	g_jobScheduler.Clear();
+	g_workerPool.Clear();
+	g_fileIOPool.Clear();
 	g_hookManager.Clear();
 	g_queryFileManager.Clear();
 	EntityCallbackDispatcher().DeleteAllCallbacks();
@@ -77,6 +108,90 @@ void ServerDeactivate_Post()
 	SET_META_RESULT(MRES_IGNORED);
 }
 
+void ClientPutInServer_Post(edict_t *pEntity)
+{
+	// the slot could be used by the previous client
+	g_playerHistory.ResetPlayer(indexOfEdict(pEntity));
+	SET_META_RESULT(MRES_IGNORED);
+}
+
+void ClientDisconnect_Post(edict_t *pEntity)
+{
+	// after client_disconnected of the plugins, the state set in client_putinserver is kept
+	g_moveModifiers.Reset(indexOfEdict(pEntity));
+	g_voiceMatrix.ResetPlayer(indexOfEdict(pEntity));
+	SET_META_RESULT(MRES_IGNORED);
+}
+
+// the game uses the resources by the original path, the replaced one is precached instead
+void SetModel(edict_t *e, const char *m)
+{
+	const char *resolved;
+	if (!g_precacheRegistry.HasRules() || !m || !(resolved = g_precacheRegistry.Resolve(PT_MODEL, m)))
+		RETURN_META(MRES_IGNORED);
+
+	// the empty model is always at index 0 of the precache list
+	g_engfuncs.pfnSetModel(e, resolved);
+	RETURN_META(MRES_SUPERCEDE);
+}
+
+int ModelIndex(const char *m)
+{
+	const char *resolved;
+	if (!g_precacheRegistry.HasRules() || !m || !(resolved = g_precacheRegistry.Resolve(PT_MODEL, m)))
+		RETURN_META_VALUE(MRES_IGNORED, 0);
+
+	RETURN_META_VALUE(MRES_SUPERCEDE, *resolved ? g_engfuncs.pfnModelIndex(resolved) : 0);
+}
+
+void EmitSound(edict_t *entity, int channel, const char *sample, float volume, float attenuation, int fFlags, int pitch)
+{
+	const char *resolved;
+	if (!g_precacheRegistry.HasRules() || !sample || !(resolved = g_precacheRegistry.Resolve(PT_SOUND, sample)))
+		RETURN_META(MRES_IGNORED);
+
+	if (*resolved)
+		g_engfuncs.pfnEmitSound(entity, channel, resolved, volume, attenuation, fFlags, pitch);
+
+	RETURN_META(MRES_SUPERCEDE);
+}
+
+void EmitAmbientSound(edict_t *entity, float *pos, const char *samp, float vol, float attenuation, int fFlags, int pitch)
+{
+	const char *resolved;
+	if (!g_precacheRegistry.HasRules() || !samp || !(resolved = g_precacheRegistry.Resolve(PT_SOUND, samp)))
+		RETURN_META(MRES_IGNORED);
+
+	if (*resolved)
+		g_engfuncs.pfnEmitAmbientSound(entity, pos, resolved, vol, attenuation, fFlags, pitch);
+
+	RETURN_META(MRES_SUPERCEDE);
+}
+
+// the teleported entity is moved to its cells of the damage grid
+void SetOrigin_Post(edict_t *pEntity, const float *rgflOrigin)
+{
+	g_damageGrid.Move(pEntity);
+	SET_META_RESULT(MRES_IGNORED);
+}
+
+void StartFrame()
+{
+	// the state at the end of previous frame
+	g_playerHistory.Record();
+	g_playerStates.Update();
+	g_damageGrid.Frame();
+
+	g_deferredHooks.Flush();
+	g_thinkBatch.Flush();
+	g_workerPool.Dispatch();
+	g_fileIOPool.Dispatch();
+	g_queryFileManager.Flush();
+	g_jobScheduler.Run();
+	g_metrics.Frame();
+	SET_META_RESULT(MRES_IGNORED);
+}
+
 void KeyValue(edict_t *pentKeyvalue, KeyValueData *pkvd)
 {
 	// get the first edict worldspawn
@@ -19,5 +19,13 @@ void ServerDeactivate_Post();
 int DispatchSpawn(edict_t* pEntity);
 void ResetGlobalState();
 void KeyValue(edict_t *pentKeyvalue, KeyValueData *pkvd);
+void ClientPutInServer_Post(edict_t *pEntity);
+void ClientDisconnect_Post(edict_t *pEntity);
+void SetModel(edict_t *e, const char *m);
+int ModelIndex(const char *m);
+void EmitSound(edict_t *entity, int channel, const char *sample, float volume, float attenuation, int fFlags, int pitch);
+void EmitAmbientSound(edict_t *entity, float *pos, const char *samp, float vol, float attenuation, int fFlags, int pitch);
+void SetOrigin_Post(edict_t *pEntity, const float *rgflOrigin);
+void StartFrame();
 
 CGameRules *InstallGameRules(IReGameHook_InstallGameRules *chain);
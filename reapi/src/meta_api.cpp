@@ -35,8 +35,8 @@ META_FUNCTIONS gMetaFunctionTable =
 	GetEntityAPI2_Post,			// pfnGetEntityAPI2_Post	META; called after game DLL
 	GetNewDLLFunctions,			// pfnGetNewDLLFunctions	HL SDK2; called before game DLL
 	NULL,			// pfnGetNewDLLFunctions_Post	META; called after game DLL
-	NULL,			// pfnGetEngineFunctions	META; called before HL engine
-	NULL,			// pfnGetEngineFunctions_Post	META; called after HL engine
+	GetEngineFunctions,			// pfnGetEngineFunctions	META; called before HL engine
+	GetEngineFunctions_Post,			// pfnGetEngineFunctions_Post	META; called after HL engine
 };
 
 C_DLLEXPORT int Meta_Attach(PLUG_LOADTIME now, META_FUNCTIONS *pFunctionTable, meta_globals_t *pMGlobals, gamedll_funcs_t *pGamedllFuncs)
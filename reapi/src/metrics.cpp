@@ -0,0 +1,378 @@
+#include "precompiled.h"
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <errno.h>
+#include <unistd.h>
+#endif
+
+CMetrics g_metrics;
+
+// upper bounds of the frame interval buckets in seconds, the last one is +Inf
+const double CMetrics::m_frameBounds[FRAME_BUCKETS - 1] = { 0.001, 0.002, 0.005, 0.01, 0.02, 0.05, 0.1, 0.25 };
+
+static void appendf(std::string &text, const char *fmt, ...)
+{
+	char buf[1024];
+
+	va_list argptr;
+	va_start(argptr, fmt);
+	int len = Q_vsnprintf(buf, sizeof(buf), fmt, argptr);
+	va_end(argptr);
+
+	if (len > 0)
+		text.append(buf, min(size_t(len), sizeof(buf) - 1));
+}
+
+static void appendHeader(std::string &text, const char *name, const char *help, const char *type)
+{
+	appendf(text, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+// Formats the snapshot and writes it out
+class CMetricsTask: public CWorkerTask
+{
+public:
+	CMetricsTask(CMetrics::snapshot_t &&snapshot, const std::string &path) : m_snapshot(std::move(snapshot)), m_path(path) {}
+
+	void Execute() override;
+	void Complete() override {}
+
+private:
+	std::string Format() const;
+
+	CMetrics::snapshot_t m_snapshot;
+	std::string m_path;
+};
+
+std::string CMetricsTask::Format() const
+{
+	const auto &s = m_snapshot;
+	std::string text;
+
+	appendHeader(text, "reapi_hook_calls_total", "Calls of the hookchains.", "counter");
+	for (auto &hook : s.hooks)
+		appendf(text, "reapi_hook_calls_total{hook=\"%s\"} %llu\n", hook.name, (unsigned long long)hook.calls);
+
+	appendHeader(text, "reapi_hook_seconds_total", "Time spent in the hookchains with the original function, measured while exporting.", "counter");
+	for (auto &hook : s.hooks)
+		appendf(text, "reapi_hook_seconds_total{hook=\"%s\"} %.6f\n", hook.name, hook.time);
+
+	appendHeader(text, "reapi_amx_forward_calls_total", "Calls of the plugin hookchain handlers.", "counter");
+	appendf(text, "reapi_amx_forward_calls_total %llu\n", (unsigned long long)s.amxCalls);
+
+	appendHeader(text, "reapi_nav_queries_total", "Navigation queries of the plugins.", "counter");
+	appendf(text, "reapi_nav_queries_total %llu\n", (unsigned long long)s.navQueries);
+
+	appendHeader(text, "reapi_entities", "Entities in use.", "gauge");
+	appendf(text, "reapi_entities %d\n", s.entities);
+
+	appendHeader(text, "reapi_free_edicts", "Edicts left for new entities.", "gauge");
+	appendf(text, "reapi_free_edicts %d\n", s.freeEdicts);
+
+	appendHeader(text, "reapi_max_edicts", "Size of the edict table.", "gauge");
+	appendf(text, "reapi_max_edicts %d\n", s.maxEdicts);
+
+	appendHeader(text, "reapi_temp_strings_peak_bytes", "Peak size of the temporary strings of the hookchains.", "gauge");
+	appendf(text, "reapi_temp_strings_peak_bytes %u\n", s.tempStringsPeak);
+
+	appendHeader(text, "reapi_frame_interval_seconds", "Time between the server frames.", "histogram");
+
+	uint64 cumulative = 0;
+	for (size_t i = 0; i < CMetrics::FRAME_BUCKETS; i++)
+	{
+		cumulative += s.frameBuckets[i];
+
+		if (i < CMetrics::FRAME_BUCKETS - 1)
+			appendf(text, "reapi_frame_interval_seconds_bucket{le=\"%g\"} %llu\n", CMetrics::m_frameBounds[i], (unsigned long long)cumulative);
+		else
+			appendf(text, "reapi_frame_interval_seconds_bucket{le=\"+Inf\"} %llu\n", (unsigned long long)cumulative);
+	}
+
+	appendf(text, "reapi_frame_interval_seconds_sum %.6f\n", s.frameSum);
+	appendf(text, "reapi_frame_interval_seconds_count %llu\n", (unsigned long long)s.frameCount);
+
+	for (auto &metric : s.metrics)
+	{
+		appendHeader(text, metric.name.c_str(), metric.help.empty() ? metric.name.c_str() : metric.help.c_str(), metric.type == METRIC_COUNTER ? "counter" : "gauge");
+		appendf(text, "%s %g\n", metric.name.c_str(), metric.value);
+	}
+
+	return text;
+}
+
+void CMetricsTask::Execute()
+{
+	std::string text = Format();
+
+	if (m_path.empty()) {
+		g_metrics.Publish(std::move(text));
+		return;
+	}
+
+	// the readers never see a half written file
+	std::string temp = m_path + ".tmp";
+
+	FILE *fp = fopen(temp.c_str(), "wb");
+	if (!fp)
+		return;
+
+	bool written = fwrite(text.data(), 1, text.size(), fp) == text.size();
+	if (fclose(fp) != 0 || !written) {
+		remove(temp.c_str());
+		return;
+	}
+
+#ifdef _WIN32
+	remove(m_path.c_str());
+#endif
+
+	rename(temp.c_str(), m_path.c_str());
+}
+
+int CMetrics::Register(const char *name, const char *help, MetricType type)
+{
+	// the plugins register them again after map change
+	for (size_t i = 0; i < m_metrics.size(); i++)
+	{
+		if (m_metrics[i].name == name)
+			return i + 1;
+	}
+
+	m_metrics.push_back({ name, help, type, 0.0 });
+	return m_metrics.size();
+}
+
+bool CMetrics::Start(float period)
+{
+	m_period = period;
+	m_nextExport = Sys_NanoTime();
+	m_lastFrame = 0;
+	m_active = true;
+	return true;
+}
+
+bool CMetrics::StartFile(const char *path, float period)
+{
+	Stop();
+
+	m_filePath = path;
+	return Start(period);
+}
+
+bool CMetrics::StartSocket(const char *path, float period)
+{
+	Stop();
+
+#ifdef _WIN32
+	return false;
+#else
+	sockaddr_un addr = {};
+	addr.sun_family = AF_UNIX;
+
+	if (Q_strlen(path) >= sizeof(addr.sun_path))
+		return false;
+
+	Q_strcpy(addr.sun_path, path);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		return false;
+
+	// the socket left by the previous run, any other file is never removed
+	if (!RemoveSocket(path)) {
+		close(fd);
+		return false;
+	}
+
+	if (bind(fd, (sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 8) != 0) {
+		close(fd);
+		return false;
+	}
+
+	m_listenSocket = fd;
+	m_socketPath = path;
+	m_filePath.clear();
+	m_stop = false;
+
+	if (!m_server.Start<CMetrics, &CMetrics::ServerLoop>(this)) {
+		close(fd);
+		RemoveSocket(path);
+		m_listenSocket = -1;
+		return false;
+	}
+
+	return Start(period);
+#endif
+}
+
+void CMetrics::Stop()
+{
+	m_active = false;
+
+#ifndef _WIN32
+	if (m_server.IsRunning()) {
+		m_stop = true;
+		m_server.Join();
+	}
+
+	if (m_listenSocket != -1) {
+		close(m_listenSocket);
+		RemoveSocket(m_socketPath.c_str());
+		m_listenSocket = -1;
+	}
+#endif
+
+	std::lock_guard<std::mutex> lock(m_textMutex);
+	m_text.clear();
+}
+
+#ifndef _WIN32
+bool CMetrics::RemoveSocket(const char *path)
+{
+	struct stat st;
+	if (lstat(path, &st) != 0)
+		return errno == ENOENT;
+
+	if (!S_ISSOCK(st.st_mode))
+		return false;
+
+	return unlink(path) == 0;
+}
+#endif
+
+void CMetrics::Publish(std::string &&text)
+{
+	std::lock_guard<std::mutex> lock(m_textMutex);
+	m_text = std::move(text);
+}
+
+void CMetrics::ServerLoop()
+{
+#ifndef _WIN32
+	while (!m_stop)
+	{
+		// wake up from time to time to check the stop flag
+		pollfd pfd = { m_listenSocket, POLLIN, 0 };
+		if (poll(&pfd, 1, 200) <= 0)
+			continue;
+
+		int client = accept(m_listenSocket, nullptr, nullptr);
+		if (client < 0)
+			continue;
+
+		// the http client sends the request first, the plain reader doesn't
+		bool http = false;
+		pollfd cfd = { client, POLLIN, 0 };
+		if (poll(&cfd, 1, 100) > 0) {
+			char request[512];
+			http = recv(client, request, sizeof(request), 0) >= 3 && !Q_strncmp(request, "GET", 3);
+		}
+
+		std::string text;
+		if (http)
+			text = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nConnection: close\r\n\r\n";
+
+		{
+			std::lock_guard<std::mutex> lock(m_textMutex);
+			text += m_text;
+		}
+
+		const char *data = text.data();
+		size_t left = text.size();
+
+		while (left > 0)
+		{
+			ssize_t sent = send(client, data, left, MSG_NOSIGNAL);
+			if (sent <= 0)
+				break;
+
+			data += sent;
+			left -= sent;
+		}
+
+		close(client);
+	}
+#endif
+}
+
+void CMetrics::Frame()
+{
+	if (!m_active)
+		return;
+
+	uint64 now = Sys_NanoTime();
+
+	if (m_lastFrame)
+	{
+		double interval = (now - m_lastFrame) / 1e9;
+
+		size_t bucket = 0;
+		while (bucket < FRAME_BUCKETS - 1 && interval > m_frameBounds[bucket])
+			bucket++;
+
+		m_frameBuckets[bucket]++;
+		m_frameCount++;
+		m_frameSum += interval;
+	}
+
+	m_lastFrame = now;
+
+	if (now < m_nextExport)
+		return;
+
+	m_nextExport = now + uint64(m_period * 1e9);
+	Export();
+}
+
+void CMetrics::Export()
+{
+	snapshot_t snapshot;
+
+	snapshot.amxCalls = m_amxCalls;
+	snapshot.navQueries = m_navQueries;
+	snapshot.tempStringsPeak = hookctx_t::s_temp_strings.GetPeakBytes();
+
+	Q_memcpy(snapshot.frameBuckets, m_frameBuckets, sizeof(m_frameBuckets));
+	snapshot.frameCount = m_frameCount;
+	snapshot.frameSum = m_frameSum;
+
+	snapshot.entities = 0;
+	snapshot.freeEdicts = 0;
+	snapshot.maxEdicts = gpGlobals->maxEntities;
+
+	if (g_pEdicts)
+	{
+		for (int index = 0; index < gpGlobals->maxEntities; index++)
+		{
+			edict_t *pEdict = edictByIndex(index);
+			if (!pEdict->free && (index == 0 || pEdict->pvPrivateData))
+				snapshot.entities++;
+		}
+
+		// the edicts above the used ones were never allocated and aren't marked free,
+		// the client slots are always in use
+		snapshot.freeEdicts = gpGlobals->maxEntities - NUMBER_OF_ENTITIES();
+	}
+
+	// only the hookchains called at least once
+	for (int table = hooklist_t::ht_engine; table <= hooklist_t::ht_botmanager; table++)
+	{
+		for (size_t index = 0; ; index++)
+		{
+			hook_t *hook = hooklist_t::getHookSafe(table * MAX_REGION_RANGE + index);
+			if (!hook)
+				break;
+
+			if (hook->calls)
+				snapshot.hooks.push_back({ hook->func_name, hook->calls, hook->time });
+		}
+	}
+
+	snapshot.metrics = m_metrics;
+
+	g_fileIOPool.Submit(new CMetricsTask(std::move(snapshot), m_filePath));
+}
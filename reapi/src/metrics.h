@@ -0,0 +1,127 @@
+#pragma once
+
+// type of the plugin metric
+enum MetricType
+{
+	METRIC_COUNTER,
+	METRIC_GAUGE,
+};
+
+// Module counters and the plugin metrics exported in Prometheus text format.
+// The values are taken on the game thread once per period,
+// the text is formatted and written by the file thread.
+class CMetrics
+{
+public:
+	bool StartFile(const char *path, float period);
+	bool StartSocket(const char *path, float period);
+	void Stop();
+	bool IsActive() const { return m_active; }
+
+	int Register(const char *name, const char *help, MetricType type);
+	bool IsValid(int handle) const { return handle > 0 && size_t(handle) <= m_metrics.size(); }
+	void Add(int handle, double value) { m_metrics[handle - 1].value += value; }
+	void Set(int handle, double value) { m_metrics[handle - 1].value = value; }
+
+	void AmxCall()  { m_amxCalls++; }
+	void NavQuery() { m_navQueries++; }
+
+	// game thread, once per frame
+	void Frame();
+
+	// the text of the last export, served by the socket
+	void Publish(std::string &&text);
+
+	static const size_t FRAME_BUCKETS = 9;
+
+	struct metric_t
+	{
+		std::string name;
+		std::string help;
+		MetricType type;
+		double value;
+	};
+
+	struct hookstat_t
+	{
+		const char *name;
+		uint64 calls;
+		double time;
+	};
+
+	struct snapshot_t
+	{
+		uint64 amxCalls;
+		uint64 navQueries;
+		int entities;
+		int freeEdicts;
+		int maxEdicts;
+		size_t tempStringsPeak;
+
+		uint64 frameBuckets[FRAME_BUCKETS];
+		uint64 frameCount;
+		double frameSum;
+
+		std::vector<hookstat_t> hooks;
+		std::vector<metric_t> metrics;
+	};
+
+	static const double m_frameBounds[FRAME_BUCKETS - 1];
+
+private:
+	bool Start(float period);
+	void Export();
+	void ServerLoop();
+
+	// removes the file only if it is a socket, true if there's nothing at the path then
+	static bool RemoveSocket(const char *path);
+
+	std::vector<metric_t> m_metrics;
+	uint64 m_amxCalls = 0;
+	uint64 m_navQueries = 0;
+
+	// histogram of the time between the frames
+	uint64 m_frameBuckets[FRAME_BUCKETS] = {};
+	uint64 m_frameCount = 0;
+	double m_frameSum = 0;
+	uint64 m_lastFrame = 0;  // nanoseconds
+
+	bool m_active = false;
+	float m_period = 0;
+	uint64 m_nextExport = 0; // nanoseconds
+	std::string m_filePath;     // empty if exported to the socket
+
+	// unix socket
+	int m_listenSocket = -1;
+	std::string m_socketPath;
+	CThread m_server;
+	std::atomic<bool> m_stop { false };
+	std::mutex m_textMutex;
+	std::string m_text;
+};
+
+extern CMetrics g_metrics;
+
+// counts the calls of the hookchain and the time spent in it
+class CHookTimer
+{
+public:
+	CHookTimer(hook_t *hook) : m_hook(hook), m_timed(g_metrics.IsActive())
+	{
+		hook->calls++;
+
+		if (m_timed)
+			m_start = Sys_NanoTime();
+	}
+
+	~CHookTimer()
+	{
+		if (m_timed)
+			m_hook->time += Sys_SecondsSince(m_start);
+	}
+
+private:
+	hook_t *m_hook;
+	bool m_timed;
+	uint64 m_start;
+};
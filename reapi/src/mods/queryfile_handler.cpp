@@ -4,33 +4,93 @@ CQueryFileManager g_queryFileManager;
 
 void CQueryFileManager::Clear()
 {
-	for (auto query : m_hooklist) {
-		delete query;
+	// the handlers of the batches are freed with their batch
+	for (auto &pair : m_byAmxxId) {
+		FreeHandler(pair.second);
 	}
 
-	m_hooklist.clear();
+	for (auto &pair : m_batches) {
+		FreeBatch(pair.second);
+	}
+
+	m_byUniqueId.clear();
+	m_byAmxxId.clear();
+	m_batches.clear();
+	m_pending.clear();
+}
+
+void CQueryFileManager::Shutdown()
+{
+	Clear();
+
+	for (auto handler : m_freeHandlers) {
+		delete handler;
+	}
+
+	m_freeHandlers.clear();
 }
 
 int CQueryFileManager::Add(AMX *amx, const char *filename, const char *funcname, ResourceType_e flag, uint32 hash)
 {
-	auto handler = new CQueryFileHandler(amx, funcname);
-	m_hooklist.push_back(handler);
+	auto handler = AllocHandler();
+	handler->Init(amx, funcname);
+
+	m_byUniqueId[handler->GetUniqueID()] = handler;
+	m_byAmxxId[handler->GetAmxxID()] = handler;
+
 	g_RecheckerFuncs->AddQueryFile(filename, flag, hash, &QueryFileHandler_Callback, handler->GetUniqueID());
 	return handler->GetAmxxID();
 }
 
+int CQueryFileManager::AddBatch(AMX *amx, const std::vector<query_t> &queries, const char *funcname)
+{
+	int amxId = g_amxxapi.RegisterSPForwardByName(amx, funcname, FP_CELL, FP_ARRAY, FP_ARRAY, FP_CELL, FP_DONE);
+	if (amxId == -1) {
+		return -1;
+	}
+
+	auto batch = new batch_t;
+	batch->amxId = amxId;
+	batch->pending = false;
+	m_batches[amxId] = batch;
+
+	for (size_t i = 0; i < queries.size(); i++)
+	{
+		auto handler = AllocHandler();
+		handler->Init(batch, i);
+		batch->handlers.push_back(handler);
+
+		m_byUniqueId[handler->GetUniqueID()] = handler;
+		g_RecheckerFuncs->AddQueryFile(queries[i].filename, queries[i].flag, queries[i].hash, &QueryFileHandler_Callback, handler->GetUniqueID());
+	}
+
+	return amxId;
+}
+
 bool CQueryFileManager::Remove(int index)
 {
-	auto iter = m_hooklist.begin();
-	while (iter != m_hooklist.end())
+	auto iter = m_byAmxxId.find(index);
+	if (iter != m_byAmxxId.end())
+	{
+		auto handler = iter->second;
+		m_byAmxxId.erase(iter);
+		m_byUniqueId.erase(handler->GetUniqueID());
+		FreeHandler(handler);
+		return true;
+	}
+
+	auto batchIter = m_batches.find(index);
+	if (batchIter != m_batches.end())
 	{
-		if ((*iter)->GetAmxxID() == index) {
-			delete (*iter);
-			iter = m_hooklist.erase(iter);
-			return true;
+		auto batch = batchIter->second;
+		m_batches.erase(batchIter);
+
+		for (auto handler : batch->handlers) {
+			m_byUniqueId.erase(handler->GetUniqueID());
 		}
-		else
-			iter++;
+
+		FreeBatch(batch);
+		return true;
 	}
 
 	return false;
@@ -38,28 +98,117 @@ bool CQueryFileManager::Remove(int index)
 
 void CQueryFileManager::FireCallback(IGameClient *pClient, uint32 hash, int uniqueId)
 {
-	for (auto query : m_hooklist)
+	auto iter = m_byUniqueId.find(uniqueId);
+	if (iter == m_byUniqueId.end()) {
+		return;
+	}
+
+	if (g_RecheckerFuncs->GetResource()->GetPrevHash() == hash) {
+		hash = 0;
+	}
+
+	auto handler = iter->second;
+	auto batch = handler->GetBatch();
+	if (!batch) {
+		g_amxxapi.ExecuteForward(handler->GetAmxxID(), pClient->GetId() + 1, hash);
+		return;
+	}
+
+	// the results of the batch are delivered once per frame
+	int client = pClient->GetId() + 1;
+	batch->files[client].push_back(handler->GetFileIndex());
+	batch->hashes[client].push_back(hash);
+
+	if (!batch->pending) {
+		batch->pending = true;
+		m_pending.push_back(batch->amxId);
+	}
+}
+
+void CQueryFileManager::Flush()
+{
+	if (m_pending.empty()) {
+		return;
+	}
+
+	std::vector<int> pending;
+	pending.swap(m_pending);
+
+	for (auto amxId : pending)
 	{
-		if (query->GetUniqueID() != uniqueId) {
-			continue;
-		}
+		for (int client = 1; client <= MAX_CLIENTS; client++)
+		{
+			// the callback could unregister the batch
+			auto iter = m_batches.find(amxId);
+			if (iter == m_batches.end()) {
+				break;
+			}
+
+			auto batch = iter->second;
+			batch->pending = false;
+
+			if (batch->files[client].empty()) {
+				continue;
+			}
 
-		if (g_RecheckerFuncs->GetResource()->GetPrevHash() == hash) {
-			hash = 0;
+			std::vector<cell> files, hashes;
+			files.swap(batch->files[client]);
+			hashes.swap(batch->hashes[client]);
+
+			g_amxxapi.ExecuteForward(amxId, client,
+				g_amxxapi.PrepareCellArrayA(files.data(), files.size(), false),
+				g_amxxapi.PrepareCellArrayA(hashes.data(), hashes.size(), false),
+				files.size());
 		}
+	}
+}
 
-		g_amxxapi.ExecuteForward(query->GetAmxxID(), pClient->GetId() + 1, hash);
+CQueryFileManager::CQueryFileHandler *CQueryFileManager::AllocHandler()
+{
+	if (m_freeHandlers.empty()) {
+		return new CQueryFileHandler;
+	}
+
+	auto handler = m_freeHandlers.back();
+	m_freeHandlers.pop_back();
+	return handler;
+}
+
+void CQueryFileManager::FreeHandler(CQueryFileHandler *handler)
+{
+	handler->Reset();
+	m_freeHandlers.push_back(handler);
+}
+
+void CQueryFileManager::FreeBatch(batch_t *batch)
+{
+	for (auto handler : batch->handlers) {
+		FreeHandler(handler);
 	}
+
+	g_amxxapi.UnregisterSPForward(batch->amxId);
+	delete batch;
 }
 
-CQueryFileManager::CQueryFileHandler::CQueryFileHandler(AMX *amx, const char *funcname)
+void CQueryFileManager::CQueryFileHandler::Init(AMX *amx, const char *funcname)
 {
 	m_amxId = g_amxxapi.RegisterSPForwardByName(amx, funcname, FP_CELL, FP_CELL, FP_DONE);
 	m_uniqueId = MAKE_REQUESTID(PLID);
+	m_batch = nullptr;
+	m_fileIndex = 0;
+}
+
+void CQueryFileManager::CQueryFileHandler::Init(batch_t *batch, int fileIndex)
+{
+	m_amxId = -1;
+	m_uniqueId = MAKE_REQUESTID(PLID);
+	m_batch = batch;
+	m_fileIndex = fileIndex;
 }
 
-CQueryFileManager::CQueryFileHandler::~CQueryFileHandler()
+void CQueryFileManager::CQueryFileHandler::Reset()
 {
+	// the forward of the batch is unregistered with the batch
 	if (m_amxId != -1) {
 		g_amxxapi.UnregisterSPForward(m_amxId);
 	}
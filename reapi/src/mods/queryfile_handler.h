@@ -3,27 +3,71 @@
 class CQueryFileManager
 {
 public:
+	struct query_t
+	{
+		const char *filename;
+		ResourceType_e flag;
+		uint32 hash;
+	};
+
 	int Add(AMX *amx, const char *filename, const char *funcname, ResourceType_e flag, uint32 hash);
+	int AddBatch(AMX *amx, const std::vector<query_t> &queries, const char *funcname);
 	void Clear();
+	void Shutdown();
 	bool Remove(int index);
 	void FireCallback(IGameClient *pClient, uint32 hash, int uniqueId);
 
+	// delivers the results of the batches collected during the frame
+	void Flush();
+
 private:
+	struct batch_t;
+
 	class CQueryFileHandler
 	{
 	public:
-		CQueryFileHandler(AMX *amx, const char *funcname);
-		~CQueryFileHandler();
+		void Init(AMX *amx, const char *funcname);
+		void Init(batch_t *batch, int fileIndex);
+		void Reset();
 
-		int GetAmxxID()   const { return m_amxId;    };
-		int GetUniqueID() const { return m_uniqueId; };
+		int GetAmxxID()     const { return m_amxId;     };
+		int GetUniqueID()   const { return m_uniqueId;  };
+		batch_t *GetBatch() const { return m_batch;     };
+		int GetFileIndex()  const { return m_fileIndex; };
 
 	private:
 		int m_amxId;
 		int m_uniqueId;
+		batch_t *m_batch;   // the handler belongs to a batch with shared forward
+		int m_fileIndex;
+	};
+
+	// files registered at once with a single forward
+	struct batch_t
+	{
+		int amxId;
+		bool pending;
+		std::vector<CQueryFileHandler *> handlers;
+
+		// results of the clients waiting for the flush
+		std::vector<cell> files[MAX_CLIENTS + 1];
+		std::vector<cell> hashes[MAX_CLIENTS + 1];
 	};
 
-	std::vector<CQueryFileHandler *> m_hooklist;
+	CQueryFileHandler *AllocHandler();
+	void FreeHandler(CQueryFileHandler *handler);
+	void FreeBatch(batch_t *batch);
+
+	// the handlers by unique ID of the query and by AMXX forward ID
+	std::unordered_map<int, CQueryFileHandler *> m_byUniqueId;
+	std::unordered_map<int, CQueryFileHandler *> m_byAmxxId;
+	std::unordered_map<int, batch_t *> m_batches;
+
+	// forward IDs of the batches with results
+	std::vector<int> m_pending;
+
+	// handlers kept for reuse
+	std::vector<CQueryFileHandler *> m_freeHandlers;
 };
 
 extern CQueryFileManager g_queryFileManager;
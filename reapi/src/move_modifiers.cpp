@@ -0,0 +1,172 @@
+#include "precompiled.h"
+
+CMoveModifiers g_moveModifiers;
+
+// sqrt(2 * 800 * 45), the jump velocity used by the game
+const float DEFAULT_JUMP_VELOCITY = 268.328157f;
+
+inline float ctof(cell value)
+{
+	return *(float *)&value;
+}
+
+void CMoveModifiers::Set(size_t index, MoveModifier type, cell value)
+{
+	auto &player = m_players[index - 1];
+
+	player.values[type] = value;
+	SetFields(player, player.fields | BIT(type));
+}
+
+cell CMoveModifiers::Get(size_t index, MoveModifier type) const
+{
+	auto &player = m_players[index - 1];
+	return (player.fields & BIT(type)) ? player.values[type] : 0;
+}
+
+void CMoveModifiers::Reset(size_t index)
+{
+	SetFields(m_players[index - 1], 0);
+}
+
+void CMoveModifiers::Reset(size_t index, MoveModifier type)
+{
+	auto &player = m_players[index - 1];
+	SetFields(player, player.fields & ~BIT(type));
+}
+
+void CMoveModifiers::Clear()
+{
+	for (auto &player : m_players)
+		SetFields(player, 0);
+
+	m_maxspeed.saved = false;
+	m_clientMaxspeed.saved = false;
+	m_friction.saved = false;
+	m_airAccelerate.saved = false;
+}
+
+void CMoveModifiers::SetFields(player_t &player, int fields)
+{
+	if (!player.fields && fields)
+	{
+		player.jumpsLeft = 0;
+
+		// the first modifier, keep PM hooks registered while any player has it
+		if (!m_active++) {
+			g_hookManager.getHook(RG_PM_Move)->acquire();
+			g_hookManager.getHook(RG_PM_Jump)->acquire();
+		}
+	}
+	else if (player.fields && !fields)
+	{
+		if (!--m_active) {
+			g_hookManager.getHook(RG_PM_Move)->release();
+			g_hookManager.getHook(RG_PM_Jump)->release();
+		}
+	}
+
+	player.fields = fields;
+}
+
+CMoveModifiers::player_t *CMoveModifiers::GetActive(const playermove_t *ppmove)
+{
+	if (!m_active || ppmove->player_index < 0 || ppmove->player_index >= MAX_CLIENTS)
+		return nullptr;
+
+	auto &player = m_players[ppmove->player_index];
+	return player.fields ? &player : nullptr;
+}
+
+void CMoveModifiers::PreMove(playermove_t *ppmove)
+{
+	auto player = GetActive(ppmove);
+	if (!player)
+		return;
+
+	auto value = [player](MoveModifier type) { return ctof(player->values[type]); };
+
+	// the overridden values are restored in PostMove
+	if (player->fields & BIT(MM_MAXSPEED)) {
+		Override(m_maxspeed, ppmove->maxspeed, ppmove->maxspeed * value(MM_MAXSPEED));
+		Override(m_clientMaxspeed, ppmove->clientmaxspeed, ppmove->clientmaxspeed * value(MM_MAXSPEED));
+	}
+
+	if (player->fields & BIT(MM_GRAVITY))
+		ppmove->gravity = value(MM_GRAVITY);
+
+	if (player->fields & BIT(MM_FRICTION))
+		Override(m_friction, ppmove->friction, value(MM_FRICTION));
+
+	if (player->fields & BIT(MM_AIRACCELERATE))
+		Override(m_airAccelerate, ppmove->movevars->airaccelerate, value(MM_AIRACCELERATE));
+
+	if (ppmove->onground != -1)
+		player->jumpsLeft = (player->fields & BIT(MM_MULTIJUMP)) ? player->values[MM_MULTIJUMP] : 0;
+}
+
+void CMoveModifiers::PostMove(playermove_t *ppmove)
+{
+	Restore(m_maxspeed, ppmove->maxspeed);
+	Restore(m_clientMaxspeed, ppmove->clientmaxspeed);
+	Restore(m_friction, ppmove->friction);
+	Restore(m_airAccelerate, ppmove->movevars->airaccelerate);
+}
+
+void CMoveModifiers::Override(saved_t &saved, float &field, float value)
+{
+	saved.saved = true;
+	saved.value = field;
+	saved.modified = value;
+	field = value;
+}
+
+void CMoveModifiers::Restore(saved_t &saved, float &field)
+{
+	if (!saved.saved)
+		return;
+
+	// the value changed by the game during the move is kept (e.g. friction reset by PM_PlayerMove)
+	if (field == saved.modified)
+		field = saved.value;
+
+	saved.saved = false;
+}
+
+void CMoveModifiers::PreJump(playermove_t *ppmove)
+{
+	auto player = GetActive(ppmove);
+	if (!player)
+		return;
+
+	// let the game jump again without releasing the button
+	if ((player->fields & BIT(MM_AUTOBHOP)) && player->values[MM_AUTOBHOP] && ppmove->onground != -1)
+		ppmove->oldbuttons &= ~IN_JUMP;
+
+	player->oldOnground = ppmove->onground;
+	player->jumpHeld = (ppmove->oldbuttons & IN_JUMP) != 0;
+}
+
+void CMoveModifiers::PostJump(playermove_t *ppmove)
+{
+	auto player = GetActive(ppmove);
+	if (!player || player->jumpHeld)
+		return;
+
+	if (player->oldOnground != -1)
+	{
+		// jumped off the ground
+		if (ppmove->onground == -1 && (player->fields & BIT(MM_JUMP_VELOCITY)))
+			ppmove->velocity[2] = ctof(player->values[MM_JUMP_VELOCITY]);
+
+		return;
+	}
+
+	// the button is pressed in the air
+	if (player->jumpsLeft > 0 && ppmove->waterlevel < 2 && ppmove->movetype == MOVETYPE_WALK)
+	{
+		player->jumpsLeft--;
+		ppmove->velocity[2] = (player->fields & BIT(MM_JUMP_VELOCITY)) ? ctof(player->values[MM_JUMP_VELOCITY]) : DEFAULT_JUMP_VELOCITY;
+		ppmove->oldbuttons |= IN_JUMP;
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+enum MoveModifier
+{
+	MM_ALL = -1,        // all modifiers, used to reset them
+
+	MM_MAXSPEED,        // multiplier of the player's maxspeed
+	MM_GRAVITY,         // gravity of the player, overrides pev->gravity
+	MM_FRICTION,        // friction of the player, overrides pev->friction
+	MM_AIRACCELERATE,   // overrides sv_airaccelerate for the player
+	MM_JUMP_VELOCITY,   // vertical velocity of the jump
+	MM_MULTIJUMP,       // count of the extra jumps in the air
+	MM_AUTOBHOP,        // jump while holding the jump button
+
+	MM_MAX
+};
+
+// Per-player movement modifiers.
+// Plugins change the table only when the player state changes,
+// the modifiers are applied to g_pMove inside PM_Move/PM_Jump hooks.
+class CMoveModifiers
+{
+public:
+	void Set(size_t index, MoveModifier type, cell value);
+	cell Get(size_t index, MoveModifier type) const;
+	bool IsSet(size_t index, MoveModifier type) const { return (m_players[index - 1].fields & BIT(type)) != 0; }
+	void Reset(size_t index);
+	void Reset(size_t index, MoveModifier type);
+	void Clear();
+
+	// called around the chain of PM_Move and PM_Jump
+	void PreMove(playermove_t *ppmove);
+	void PostMove(playermove_t *ppmove);
+	void PreJump(playermove_t *ppmove);
+	void PostJump(playermove_t *ppmove);
+
+private:
+	struct player_t
+	{
+		int fields;             // bits of the set modifiers
+		cell values[MM_MAX];
+
+		int jumpsLeft;          // extra jumps left until landing
+		int oldOnground;
+		bool jumpHeld;
+	};
+
+	// value of g_pMove overridden for the current move
+	struct saved_t
+	{
+		bool saved;
+		float value;            // value before the modifier
+		float modified;         // value set by the modifier
+	};
+
+	player_t *GetActive(const playermove_t *ppmove);
+	void SetFields(player_t &player, int fields);
+
+	static void Override(saved_t &saved, float &field, float value);
+	static void Restore(saved_t &saved, float &field);
+
+	player_t m_players[MAX_CLIENTS] = {};
+	size_t m_active = 0;        // count of players with modifiers
+
+	// the engine copies maxspeed and friction back to the player after the move,
+	// movevars are shared between the players
+	saved_t m_maxspeed = {};
+	saved_t m_clientMaxspeed = {};
+	saved_t m_friction = {};
+	saved_t m_airAccelerate = {};
+};
+
+extern CMoveModifiers g_moveModifiers;
@@ -0,0 +1,342 @@
+#include "precompiled.h"
+
+// checks the callback of the task exists
+static const char *getCallback(AMX *amx, cell addr, char (&namebuf)[256], const char *native)
+{
+	const char *funcname = getAmxString(amx, addr, namebuf);
+
+	int funcid;
+	if (unlikely(g_amxxapi.amx_FindPublic(amx, funcname, &funcid) != AMX_ERR_NONE)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: public function \"%s\" not found.", native, funcname);
+		return nullptr;
+	}
+
+	return funcname;
+}
+
+// copies the string of any length
+static std::string getAmxText(AMX *amx, cell addr)
+{
+	cell *src = getAmxAddr(amx, addr);
+
+	std::string text;
+	while (*src)
+		text.push_back(char(*src++));
+
+	return text;
+}
+
+/*
+* Sorts a copy of the array on a worker thread, the result is passed to the callback at the next frame.
+* @note The array is sorted by records of blocksize cells, compared by the key cell at keyoffset of the record.
+* @note Callback should be contains passing arguments as "public Sort_Callback(const task, const data[], const size, const userdata)"
+*
+* @param data       Array to sort
+* @param size       Size of data
+* @param callback   The forward to call
+* @param type       Key type and order, see AsyncSort enum
+* @param blocksize  Size of the record
+* @param keyoffset  Offset of the key in the record
+* @param userdata   Optional value passed to the callback
+*
+* @return           Task index, 0 on failure
+*
+* native AsyncSortArray(const data[], const size, const callback[], const AsyncSort:type = AS_INT_ASCENDING, const blocksize = 1, const keyoffset = 0, const userdata = 0);
+*/
+cell AMX_NATIVE_CALL AsyncSortArray(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_data, arg_size, arg_handler, arg_type, arg_blocksize, arg_keyoffset, arg_userdata };
+
+	char namebuf[256];
+	const char *funcname = getCallback(amx, params[arg_handler], namebuf, __FUNCTION__);
+	if (unlikely(funcname == nullptr))
+		return FALSE;
+
+	AsyncSort type = static_cast<AsyncSort>(params[arg_type]);
+	if (unlikely(type < AS_INT_ASCENDING || type > AS_FLOAT_DESCENDING)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid sort type %d", __FUNCTION__, type);
+		return FALSE;
+	}
+
+	cell size = params[arg_size], blocksize = params[arg_blocksize], keyoffset = params[arg_keyoffset];
+	if (unlikely(size < 0 || blocksize <= 0 || size % blocksize != 0)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: size %d isn't a multiple of the block size %d", __FUNCTION__, size, blocksize);
+		return FALSE;
+	}
+
+	if (unlikely(keyoffset < 0 || keyoffset >= blocksize)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid key offset %d", __FUNCTION__, keyoffset);
+		return FALSE;
+	}
+
+	int fwdid = g_amxxapi.RegisterSPForwardByName(amx, funcname, FP_CELL, FP_ARRAY, FP_CELL, FP_CELL, FP_DONE);
+	if (unlikely(fwdid == -1))
+		return FALSE;
+
+	auto task = new CSortTask(amx, fwdid, params[arg_userdata], getAmxAddr(amx, params[arg_data]), size, blocksize, keyoffset, type);
+	int id = task->GetId();
+
+	g_workerPool.Submit(task);
+	return id;
+}
+
+/*
+* Computes CRC32 and size of the files on a worker thread, the result is passed to the callback at the next frame.
+* @note The paths are relative to the mod directory.
+* @note Callback should be contains passing arguments as "public Hash_Callback(const task, const hashes[], const sizes[], const count, const userdata)",
+*       the size is -1 if the file can't be read.
+*
+* @param files      Array of the file paths
+* @param count      Count of the files
+* @param callback   The forward to call
+* @param userdata   Optional value passed to the callback
+*
+* @return           Task index, 0 on failure
+*
+* native AsyncHashFiles(const files[][], const count, const callback[], const userdata = 0);
+*/
+cell AMX_NATIVE_CALL AsyncHashFiles(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_files, arg_num, arg_handler, arg_userdata };
+
+	char namebuf[256];
+	const char *funcname = getCallback(amx, params[arg_handler], namebuf, __FUNCTION__);
+	if (unlikely(funcname == nullptr))
+		return FALSE;
+
+	if (unlikely(params[arg_num] < 0)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid count %d", __FUNCTION__, params[arg_num]);
+		return FALSE;
+	}
+
+	int fwdid = g_amxxapi.RegisterSPForwardByName(amx, funcname, FP_CELL, FP_ARRAY, FP_ARRAY, FP_CELL, FP_CELL, FP_DONE);
+	if (unlikely(fwdid == -1))
+		return FALSE;
+
+	auto task = new CHashFilesTask(amx, fwdid, params[arg_userdata]);
+	cell *table = getAmxAddr(amx, params[arg_files]);
+
+	for (cell i = 0; i < params[arg_num]; i++)
+	{
+		// the rows are reached through the indirection vector of the array
+		cell *row = (cell *)((uint8 *)&table[i] + table[i]);
+
+		char filename[256], path[260];
+		getAmxString(row, filename);
+		task->AddFile(g_amxxapi.BuildPathnameR(path, sizeof(path), "%s", filename));
+	}
+
+	int id = task->GetId();
+
+	g_workerPool.Submit(task);
+	return id;
+}
+
+/*
+* Parses the file of "key value" or "key = value" lines on a worker thread, the result is passed to the callback at the next frame.
+* @note Empty lines and lines starting with ; # or // are skipped, the quotes around the key or value are removed.
+* @note Callback should be contains passing arguments as "public Config_Callback(const task, const buffer[], const offsets[], const count, const userdata)",
+*       the key and value of the pair N are the strings at buffer[offsets[N * 2]] and buffer[offsets[N * 2 + 1]],
+*       the count is -1 if the file can't be opened.
+*
+* @param file       Path to the file relative to the mod directory
+* @param callback   The forward to call
+* @param userdata   Optional value passed to the callback
+*
+* @return           Task index, 0 on failure
+*
+* native AsyncParseConfig(const file[], const callback[], const userdata = 0);
+*/
+cell AMX_NATIVE_CALL AsyncParseConfig(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_file, arg_handler, arg_userdata };
+
+	char namebuf[256];
+	const char *funcname = getCallback(amx, params[arg_handler], namebuf, __FUNCTION__);
+	if (unlikely(funcname == nullptr))
+		return FALSE;
+
+	int fwdid = g_amxxapi.RegisterSPForwardByName(amx, funcname, FP_CELL, FP_ARRAY, FP_ARRAY, FP_CELL, FP_CELL, FP_DONE);
+	if (unlikely(fwdid == -1))
+		return FALSE;
+
+	char filename[256], path[260];
+	getAmxString(amx, params[arg_file], filename);
+
+	auto task = new CParseConfigTask(amx, fwdid, params[arg_userdata], g_amxxapi.BuildPathnameR(path, sizeof(path), "%s", filename));
+	int id = task->GetId();
+
+	g_workerPool.Submit(task);
+	return id;
+}
+
+/*
+* Reads the whole file on the file thread, the callback is called at the next frame.
+* @note The path is relative to the mod directory.
+* @note Callback should be contains passing arguments as "public Read_Callback(const task, const length, const userdata)",
+*       the length is -1 if the file can't be read. The content is copied by AsyncReadData inside the callback.
+*
+* @param file       Path to the file
+* @param callback   The forward to call
+* @param userdata   Optional value passed to the callback
+*
+* @return           Task index, 0 on failure
+*
+* native AsyncReadFile(const file[], const callback[], const userdata = 0);
+*/
+cell AMX_NATIVE_CALL AsyncReadFile(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_file, arg_handler, arg_userdata };
+
+	char namebuf[256];
+	const char *funcname = getCallback(amx, params[arg_handler], namebuf, __FUNCTION__);
+	if (unlikely(funcname == nullptr))
+		return FALSE;
+
+	int fwdid = g_amxxapi.RegisterSPForwardByName(amx, funcname, FP_CELL, FP_CELL, FP_CELL, FP_DONE);
+	if (unlikely(fwdid == -1))
+		return FALSE;
+
+	char filename[256], path[260];
+	getAmxString(amx, params[arg_file], filename);
+
+	auto task = new CReadFileTask(amx, fwdid, params[arg_userdata], g_amxxapi.BuildPathnameR(path, sizeof(path), "%s", filename));
+	int id = task->GetId();
+
+	g_fileIOPool.Submit(task);
+	return id;
+}
+
+/*
+* Copies a part of the content read by AsyncReadFile to the buffer as a string.
+* @note Usable only inside the callback of the read, the content is freed after it.
+*
+* @param task       Task index passed to the callback
+* @param offset     Offset in the content
+* @param buffer     Buffer to copy the content to
+* @param maxlen     Maximum size of the buffer, the copied part is maxlen - 1 chars at most
+*
+* @return           Count of the copied chars, 0 at the end of the content
+*
+* native AsyncReadData(const task, const offset, buffer[], const maxlen);
+*/
+cell AMX_NATIVE_CALL AsyncReadData(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_task, arg_offset, arg_buffer, arg_maxlen };
+
+	auto task = CReadFileTask::GetCurrent();
+	if (unlikely(task == nullptr || task->GetId() != params[arg_task])) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: task %d isn't in its read callback", __FUNCTION__, params[arg_task]);
+		return 0;
+	}
+
+	if (unlikely(params[arg_offset] < 0 || params[arg_maxlen] < 0)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid offset %d or size %d", __FUNCTION__, params[arg_offset], params[arg_maxlen]);
+		return 0;
+	}
+
+	return task->Read(params[arg_offset], getAmxAddr(amx, params[arg_buffer]), params[arg_maxlen]);
+}
+
+// registers the optional callback of the write
+static bool getWriteCallback(AMX *amx, cell addr, const char *native, int &fwdid)
+{
+	fwdid = -1;
+
+	char namebuf[256];
+	const char *funcname = getAmxString(amx, addr, namebuf);
+	if (funcname == nullptr || funcname[0] == '\0')
+		return true;
+
+	funcname = getCallback(amx, addr, namebuf, native);
+	if (unlikely(funcname == nullptr))
+		return false;
+
+	fwdid = g_amxxapi.RegisterSPForwardByName(amx, funcname, FP_CELL, FP_CELL, FP_CELL, FP_DONE);
+	return fwdid != -1;
+}
+
+/*
+* Appends the text to the file on the file thread.
+* @note The appends to the same file queued meanwhile are written at once, the operations on the file keep their order.
+* @note The queued writes are done even after map change, but the callbacks aren't called then.
+* @note Callback should be contains passing arguments as "public Write_Callback(const task, const bool:success, const userdata)"
+*
+* @param file       Path to the file relative to the mod directory
+* @param text       Text to append
+* @param callback   Optional forward to call
+* @param userdata   Optional value passed to the callback
+*
+* @return           Task index, 0 on failure
+*
+* native AsyncAppendFile(const file[], const text[], const callback[] = "", const userdata = 0);
+*/
+cell AMX_NATIVE_CALL AsyncAppendFile(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_file, arg_text, arg_handler, arg_userdata };
+
+	int fwdid;
+	if (unlikely(!getWriteCallback(amx, params[arg_handler], __FUNCTION__, fwdid)))
+		return FALSE;
+
+	char filename[256], path[260];
+	getAmxString(amx, params[arg_file], filename);
+
+	auto task = new CAppendFileTask(amx, fwdid, params[arg_userdata], g_amxxapi.BuildPathnameR(path, sizeof(path), "%s", filename), getAmxText(amx, params[arg_text]));
+	int id = task->GetId();
+
+	g_fileIOPool.Submit(task);
+	return id;
+}
+
+/*
+* Replaces the file with the text on the file thread.
+* @note The text is written to a temporary file first and renamed then, so the file is never left half written.
+* @note The queued writes are done even after map change, but the callbacks aren't called then.
+* @note Callback should be contains passing arguments as "public Write_Callback(const task, const bool:success, const userdata)"
+*
+* @param file       Path to the file relative to the mod directory
+* @param text       New content of the file
+* @param callback   Optional forward to call
+* @param userdata   Optional value passed to the callback
+*
+* @return           Task index, 0 on failure
+*
+* native AsyncWriteFile(const file[], const text[], const callback[] = "", const userdata = 0);
+*/
+cell AMX_NATIVE_CALL AsyncWriteFile(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_file, arg_text, arg_handler, arg_userdata };
+
+	int fwdid;
+	if (unlikely(!getWriteCallback(amx, params[arg_handler], __FUNCTION__, fwdid)))
+		return FALSE;
+
+	char filename[256], path[260];
+	getAmxString(amx, params[arg_file], filename);
+
+	auto task = new CWriteFileTask(amx, fwdid, params[arg_userdata], g_amxxapi.BuildPathnameR(path, sizeof(path), "%s", filename), getAmxText(amx, params[arg_text]));
+	int id = task->GetId();
+
+	g_fileIOPool.Submit(task);
+	return id;
+}
+
+AMX_NATIVE_INFO Natives_Async[] =
+{
+	{ "AsyncSortArray",   AsyncSortArray   },
+	{ "AsyncHashFiles",   AsyncHashFiles   },
+	{ "AsyncParseConfig", AsyncParseConfig },
+
+	{ "AsyncReadFile",    AsyncReadFile    },
+	{ "AsyncReadData",    AsyncReadData    },
+	{ "AsyncAppendFile",  AsyncAppendFile  },
+	{ "AsyncWriteFile",   AsyncWriteFile   },
+
+	{ nullptr, nullptr }
+};
+
+void RegisterNatives_Async()
+{
+	g_amxxapi.AddNatives(Natives_Async);
+}
@@ -312,6 +312,93 @@ cell AMX_NATIVE_CALL amx_GetAttachment(AMX *amx, cell *params)
 	return TRUE;
 }
 
+/*
+* Gets the positions of several bones at once
+*
+* @param entity     Entity index
+* @param bones      Numbers of the bones
+* @param origins    Array to store origins in, new origins[count][3]
+* @param count      Count of the bones
+*
+* @note The skeleton is set up once per frame and animation state of the entity,
+*       all bones are read from it.
+*
+* @return           1 on success, 0 otherwise
+* @error            If the index is not within the range of 1 to maxEntities or
+*                   the entity is not valid, an error will be thrown.
+*
+* native GetBonePositions(const entity, const bones[], Float:origins[][3], const count = sizeof(bones));
+*/
+cell AMX_NATIVE_CALL amx_GetBonePositions(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_index, arg_bones, arg_origins, arg_size };
+
+	CHECK_ISENTITY(arg_index);
+
+	CBaseEntity *pEntity = getPrivate<CBaseEntity>(params[arg_index]);
+	if (unlikely(pEntity == nullptr)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid or uninitialized entity", __FUNCTION__);
+		return FALSE;
+	}
+
+	if (FNullEnt(params[arg_index])) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: worldspawn not allowed", __FUNCTION__);
+		return FALSE;
+	}
+
+	if (params[arg_size] > 0) {
+		GetBonePositions(pEntity, getAmxAddr(amx, params[arg_bones]), getAmxAddr(amx, params[arg_origins]), params[arg_size]);
+	}
+
+	return TRUE;
+}
+
+/*
+* Gets the positions of several attachments at once
+*
+* @param entity      Entity index
+* @param attachments Numbers of the attachments
+* @param origins     Array to store origins in, new origins[count][3]
+* @param count       Count of the attachments
+*
+* @note The skeleton is set up once per frame and animation state of the entity,
+*       all attachments are read from it.
+*
+* @return            1 on success, 0 otherwise
+* @error             If the index is not within the range of 1 to maxEntities or
+*                    the entity is not valid, an error will be thrown.
+*
+* native GetAttachments(const entity, const attachments[], Float:origins[][3], const count = sizeof(attachments));
+*/
+cell AMX_NATIVE_CALL amx_GetAttachments(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_index, arg_attachments, arg_origins, arg_size };
+
+	CHECK_ISENTITY(arg_index);
+
+	CBaseEntity *pEntity = getPrivate<CBaseEntity>(params[arg_index]);
+	if (unlikely(pEntity == nullptr)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid or uninitialized entity", __FUNCTION__);
+		return FALSE;
+	}
+
+	if (FNullEnt(params[arg_index])) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: worldspawn not allowed", __FUNCTION__);
+		return FALSE;
+	}
+
+	cell *attachments = getAmxAddr(amx, params[arg_attachments]);
+	cell *origins = getAmxAddr(amx, params[arg_origins]);
+
+	for (cell i = 0; i < params[arg_size]; i++)
+	{
+		Vector *pVecOrigin = (Vector *)((uint8 *)&origins[i] + origins[i]);
+		GetAttachment(pEntity, attachments[i], pVecOrigin, nullptr);
+	}
+
+	return TRUE;
+}
+
 /*
 * Sets body group value based on entity's model group
 *
@@ -686,6 +773,365 @@ cell AMX_NATIVE_CALL amx_CheckVisibilityInOrigin(AMX *amx, cell *params)
 	return ENGINE_CHECK_VISIBILITY(pEntity->edict(), pSet);
 }
 
+/*
+* Gets the state of the player at the given time from the position history.
+* @note The history is recorded once per server frame (at most 1000 times a second) and keeps a second.
+*
+* @param player     Player index
+* @param time       Server time, the state is interpolated between the frames
+* @param data       Array to store the state in, see PlayerHistory enum
+*
+* @return           true on success, false if the time is older than the history
+*
+* native bool:GetPlayerHistory(const player, const Float:time, data[PlayerHistory]);
+*/
+cell AMX_NATIVE_CALL amx_GetPlayerHistory(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_index, arg_time, arg_data };
+
+	CHECK_ISPLAYER(arg_index);
+
+	CPlayerHistory::record_t state;
+	if (!g_playerHistory.GetState(params[arg_index], *(float *)&params[arg_time], state))
+		return FALSE;
+
+	cell *dest = getAmxAddr(amx, params[arg_data]);
+	Q_memcpy(dest, &state, sizeof(state));
+	return TRUE;
+}
+
+/*
+* Traces a line against the players moved back to the given time.
+*
+* @param time       Server time to rewind the players to
+* @param start      Start position
+* @param end        End position
+* @param noMonsters Trace flags, see IGNORE_* constants in hlsdk_const.inc
+* @param skip       Entity to skip, it's not moved back either
+* @param trace      Trace handle, created by create_tr2
+*
+* @noreturn
+*
+* native TraceLineHistory(const Float:time, const Float:start[3], const Float:end[3], const noMonsters, const skip, const trace);
+*/
+cell AMX_NATIVE_CALL amx_TraceLineHistory(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_time, arg_start, arg_end, arg_nomonsters, arg_skip, arg_trace };
+
+	CHECK_ISENTITY(arg_skip);
+
+	if (unlikely(!params[arg_trace])) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid trace handle", __FUNCTION__);
+		return FALSE;
+	}
+
+	CAmxArgs args(amx, params);
+	edict_t *pSkip = params[arg_skip] ? edictByIndex(params[arg_skip]) : nullptr;
+
+	g_playerHistory.Rewind(args[arg_time], pSkip);
+	TRACE_LINE(args[arg_start], args[arg_end], params[arg_nomonsters], pSkip, (TraceResult *)params[arg_trace]);
+	g_playerHistory.Restore();
+
+	return TRUE;
+}
+
+/*
+* Traces a hull against the players moved back to the given time.
+*
+* @param time       Server time to rewind the players to
+* @param start      Start position
+* @param end        End position
+* @param noMonsters Trace flags, see IGNORE_* constants in hlsdk_const.inc
+* @param hull       Hull type, see HULL_* constants in hlsdk_const.inc
+* @param skip       Entity to skip, it's not moved back either
+* @param trace      Trace handle, created by create_tr2
+*
+* @noreturn
+*
+* native TraceHullHistory(const Float:time, const Float:start[3], const Float:end[3], const noMonsters, const hull, const skip, const trace);
+*/
+cell AMX_NATIVE_CALL amx_TraceHullHistory(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_time, arg_start, arg_end, arg_nomonsters, arg_hull, arg_skip, arg_trace };
+
+	CHECK_ISENTITY(arg_skip);
+
+	if (unlikely(!params[arg_trace])) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid trace handle", __FUNCTION__);
+		return FALSE;
+	}
+
+	CAmxArgs args(amx, params);
+	edict_t *pSkip = params[arg_skip] ? edictByIndex(params[arg_skip]) : nullptr;
+
+	g_playerHistory.Rewind(args[arg_time], pSkip);
+	TRACE_HULL(args[arg_start], args[arg_end], params[arg_nomonsters], params[arg_hull], pSkip, (TraceResult *)params[arg_trace]);
+	g_playerHistory.Restore();
+
+	return TRUE;
+}
+
+/*
+* Schedules a job, the callback is called at the start of each frame while the time budget
+* of the job lasts and the rest of the work carries over to next frame.
+* @note The callback does a small step of the work per call and returns JOB_CONTINUE to be called again
+*       or JOB_DONE when the work is finished, the data array keeps the state of the job between the calls.
+* @note Callback should be contains passing arguments as "public Job_Callback(const job, data[], const size)"
+* @note The jobs of higher priority run first, all jobs are removed on map change.
+*
+* @param callback   The forward to call
+* @param data       Optional state of the job passed to the callback
+* @param size       Optional size of data
+* @param priority   Priority of the job
+* @param budget     Time of the job per frame in microseconds
+*
+* @return           Job index, 0 on failure
+*
+* native ScheduleJob(const callback[], const data[] = "", const size = 0, const priority = 0, const budget = 1000);
+*/
+cell AMX_NATIVE_CALL amx_ScheduleJob(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_handler, arg_data, arg_size, arg_priority, arg_budget };
+
+	char namebuf[256];
+	const char *funcname = getAmxString(amx, params[arg_handler], namebuf);
+
+	int funcid;
+	if (unlikely(g_amxxapi.amx_FindPublic(amx, funcname, &funcid) != AMX_ERR_NONE)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: public function \"%s\" not found.", __FUNCTION__, funcname);
+		return FALSE;
+	}
+
+	if (unlikely(params[arg_size] < 0)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid data size %d", __FUNCTION__, params[arg_size]);
+		return FALSE;
+	}
+
+	if (unlikely(params[arg_budget] <= 0)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid budget %d", __FUNCTION__, params[arg_budget]);
+		return FALSE;
+	}
+
+	cell *data = getAmxAddr(amx, params[arg_data]);
+	return g_jobScheduler.Add(amx, funcname, data, params[arg_size], params[arg_priority], params[arg_budget]);
+}
+
+/*
+* Removes the scheduled job.
+*
+* @param job        Job index
+*
+* @return           true on success, false if the job is finished or not found
+*
+* native bool:CancelJob(const job);
+*/
+cell AMX_NATIVE_CALL amx_CancelJob(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_job };
+
+	return g_jobScheduler.Remove(params[arg_job]) ? TRUE : FALSE;
+}
+
+/*
+* Checks if the job is still scheduled.
+*
+* @param job        Job index
+*
+* @return           true/false
+*
+* native bool:IsJobScheduled(const job);
+*/
+cell AMX_NATIVE_CALL amx_IsJobScheduled(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_job };
+
+	return g_jobScheduler.IsValid(params[arg_job]) ? TRUE : FALSE;
+}
+
+/*
+* Sets the total time of all jobs per frame, the jobs left over wait for next frame.
+*
+* @param budget     Time in microseconds, 0 is unlimited
+*
+* @noreturn
+*
+* native SetJobsFrameBudget(const budget);
+*/
+cell AMX_NATIVE_CALL amx_SetJobsFrameBudget(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_budget };
+
+	if (unlikely(params[arg_budget] < 0)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid budget %d", __FUNCTION__, params[arg_budget]);
+		return FALSE;
+	}
+
+	g_jobScheduler.SetFrameBudget(params[arg_budget]);
+	return TRUE;
+}
+
+/*
+* Starts exporting the metrics to the file in Prometheus text format, e.g. for the textfile collector of node exporter.
+* @note The values are taken once per period and the file is written by a background thread, the export keeps running over map changes.
+*
+* @param file       Path to the file relative to the mod directory
+* @param period     Time between the exports in seconds
+*
+* @return           true on success, false otherwise
+*
+* native bool:MetricsExportFile(const file[], const Float:period = 10.0);
+*/
+cell AMX_NATIVE_CALL amx_MetricsExportFile(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_file, arg_period };
+
+	CAmxArgs args(amx, params);
+	if (unlikely(float(args[arg_period]) <= 0.0f)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid period %f", __FUNCTION__, float(args[arg_period]));
+		return FALSE;
+	}
+
+	char filename[256], path[260];
+	getAmxString(amx, params[arg_file], filename);
+
+	return g_metrics.StartFile(g_amxxapi.BuildPathnameR(path, sizeof(path), "%s", filename), args[arg_period]) ? TRUE : FALSE;
+}
+
+/*
+* Starts serving the metrics in Prometheus text format on the unix domain socket.
+* @note A client sending a GET request gets a HTTP response, otherwise the text is written right away,
+*       e.g. "curl --unix-socket <path> http://localhost/metrics"
+* @note Linux only.
+* @note A socket left at the path is replaced, the export fails if there's any other file.
+*
+* @param path       Absolute path of the socket
+* @param period     Time between the updates of the values in seconds
+*
+* @return           true on success, false otherwise
+*
+* native bool:MetricsExportSocket(const path[], const Float:period = 10.0);
+*/
+cell AMX_NATIVE_CALL amx_MetricsExportSocket(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_path, arg_period };
+
+	CAmxArgs args(amx, params);
+	if (unlikely(float(args[arg_period]) <= 0.0f)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid period %f", __FUNCTION__, float(args[arg_period]));
+		return FALSE;
+	}
+
+	char path[256];
+	getAmxString(amx, params[arg_path], path);
+
+	return g_metrics.StartSocket(path, args[arg_period]) ? TRUE : FALSE;
+}
+
+/*
+* Stops exporting the metrics.
+*
+* @noreturn
+*
+* native MetricsStop();
+*/
+cell AMX_NATIVE_CALL amx_MetricsStop(AMX *amx, cell *params)
+{
+	g_metrics.Stop();
+	return TRUE;
+}
+
+/*
+* Registers the metric of the plugin exported along with the module metrics.
+* @note The metric of the same name is shared, the value is kept over map changes.
+*
+* @param name       Name of the metric, e.g. "myplugin_kills_total"
+* @param help       Description of the metric
+* @param type       Type of the metric, see MetricType enum
+*
+* @return           Metric handle, 0 on failure
+*
+* native RegisterMetric(const name[], const help[] = "", const MetricType:type = METRIC_COUNTER);
+*/
+cell AMX_NATIVE_CALL amx_RegisterMetric(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_name, arg_help, arg_type };
+
+	char name[128], help[256];
+	getAmxString(amx, params[arg_name], name);
+	getAmxString(amx, params[arg_help], help);
+
+	// [a-zA-Z_:][a-zA-Z0-9_:]*
+	bool valid = name[0] != '\0' && !isdigit((unsigned char)name[0]);
+	for (const char *c = name; *c && valid; c++)
+		valid = isalnum((unsigned char)*c) || *c == '_' || *c == ':';
+
+	if (unlikely(!valid)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid metric name \"%s\"", __FUNCTION__, name);
+		return FALSE;
+	}
+
+	if (unlikely(params[arg_type] != METRIC_COUNTER && params[arg_type] != METRIC_GAUGE)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid metric type %d", __FUNCTION__, params[arg_type]);
+		return FALSE;
+	}
+
+	// the newlines would break the text format
+	for (char *c = help; *c; c++) {
+		if (*c == '\n' || *c == '\r')
+			*c = ' ';
+	}
+
+	return g_metrics.Register(name, help, static_cast<MetricType>(params[arg_type]));
+}
+
+/*
+* Adds the value to the metric.
+*
+* @param metric     Metric handle
+* @param value      Value to add
+*
+* @noreturn
+*
+* native MetricAdd(const metric, const Float:value = 1.0);
+*/
+cell AMX_NATIVE_CALL amx_MetricAdd(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_metric, arg_value };
+
+	if (unlikely(!g_metrics.IsValid(params[arg_metric]))) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid metric handle %d", __FUNCTION__, params[arg_metric]);
+		return FALSE;
+	}
+
+	CAmxArgs args(amx, params);
+	g_metrics.Add(params[arg_metric], float(args[arg_value]));
+	return TRUE;
+}
+
+/*
+* Sets the value of the metric.
+*
+* @param metric     Metric handle
+* @param value      New value
+*
+* @noreturn
+*
+* native MetricSet(const metric, const Float:value);
+*/
+cell AMX_NATIVE_CALL amx_MetricSet(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_metric, arg_value };
+
+	if (unlikely(!g_metrics.IsValid(params[arg_metric]))) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid metric handle %d", __FUNCTION__, params[arg_metric]);
+		return FALSE;
+	}
+
+	CAmxArgs args(amx, params);
+	g_metrics.Set(params[arg_metric], float(args[arg_value]));
+	return TRUE;
+}
+
 AMX_NATIVE_INFO Natives_Common[] =
 {
 	{ "FClassnameIs",         amx_FClassnameIs         },
@@ -698,6 +1144,8 @@ AMX_NATIVE_INFO Natives_Common[] =
 	{ "set_key_value_buffer", amx_set_key_value_buffer },
 	{ "GetBonePosition",      amx_GetBonePosition      },
 	{ "GetAttachment",        amx_GetAttachment        },
+	{ "GetBonePositions",     amx_GetBonePositions     },
+	{ "GetAttachments",       amx_GetAttachments       },
 	{ "GetBodygroup",         amx_GetBodygroup         },
 	{ "SetBodygroup",         amx_SetBodygroup         },
 	{ "GetSequenceInfo",      amx_GetSequenceInfo      },
@@ -709,6 +1157,22 @@ AMX_NATIVE_INFO Natives_Common[] =
 
 	{ "CheckVisibilityInOrigin", amx_CheckVisibilityInOrigin },
 
+	{ "GetPlayerHistory",     amx_GetPlayerHistory     },
+	{ "TraceLineHistory",     amx_TraceLineHistory     },
+	{ "TraceHullHistory",     amx_TraceHullHistory     },
+
+	{ "ScheduleJob",          amx_ScheduleJob          },
+	{ "CancelJob",            amx_CancelJob            },
+	{ "IsJobScheduled",       amx_IsJobScheduled       },
+	{ "SetJobsFrameBudget",   amx_SetJobsFrameBudget   },
+
+	{ "MetricsExportFile",    amx_MetricsExportFile    },
+	{ "MetricsExportSocket",  amx_MetricsExportSocket  },
+	{ "MetricsStop",          amx_MetricsStop          },
+	{ "RegisterMetric",       amx_RegisterMetric       },
+	{ "MetricAdd",            amx_MetricAdd            },
+	{ "MetricSet",            amx_MetricSet            },
+
 	{ nullptr, nullptr }
 };
 
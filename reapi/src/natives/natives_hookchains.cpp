@@ -1,5 +1,41 @@
 #include "precompiled.h"
 
+static cell RegisterHookChainHandler(AMX *amx, int func, cell handler, bool post, fwdmode mode, const char *caller)
+{
+	auto hook = g_hookManager.getHook(func);
+
+	if (unlikely(hook == nullptr))
+	{
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: function with id (%d) doesn't exist in current API version.", caller, func);
+		return INVALID_HOOKCHAIN;
+	}
+
+	if (unlikely(!hook->checkRequirements()))
+	{
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: function (%s) is not available, %s required.", caller, hook->func_name, hook->depend_name);
+		return INVALID_HOOKCHAIN;
+	}
+
+	char namebuf[256];
+	const char *funcname = getAmxString(amx, handler, namebuf);
+
+	int funcid;
+	if (unlikely(g_amxxapi.amx_FindPublic(amx, funcname, &funcid) != AMX_ERR_NONE))
+	{
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: public function \"%s\" not found.", caller, funcname);
+		return INVALID_HOOKCHAIN;
+	}
+
+	int fwid = hook->registerForward(amx, funcname);
+	if (unlikely(fwid == -1))
+	{
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: register forward failed.", caller);
+		return INVALID_HOOKCHAIN;
+	}
+
+	return g_hookManager.addHandler(amx, func, funcname, fwid, post, mode);
+}
+
 /*
 * Hook API function that are available into enum.
 * Look at the enums for parameter lists.
@@ -16,16 +52,69 @@ cell AMX_NATIVE_CALL RegisterHookChain(AMX *amx, cell *params)
 {
 	enum args_e { arg_count, arg_func, arg_handler, arg_post };
 
+	return RegisterHookChainHandler(amx, params[arg_func], params[arg_handler], params[arg_post] != 0, FMODE_INPLACE, __FUNCTION__);
+}
+
+/*
+* Hook API function as deferred post hook.
+* Arguments are copied at the call and the handler is executed at the start of next frame,
+* so it can only observe the call, its return value can't change anything.
+*
+* @note Entity indexes may be not valid anymore by the time of the call, pointers and handles (traces, buffers) are passed as 0.
+* @note GetHookChainReturn is available for integer, float and boolean return values.
+* @note Plugins running in debug mode get the handler called in place as a usual post hook.
+*
+* @param function   The function to hook
+* @param callback   The forward to call
+*
+* @return           Returns a hook handle. Use EnableHookChain/DisableHookChain to toggle the forward on or off
+*
+* native HookChain:RegisterHookChainDeferred(any:function_id, const callback[]);
+*/
+cell AMX_NATIVE_CALL RegisterHookChainDeferred(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_func, arg_handler };
+
+	return RegisterHookChainHandler(amx, params[arg_func], params[arg_handler], true, FMODE_DEFERRED, __FUNCTION__);
+}
+
+/*
+* Hook CBasePlayer::PreThink or CBasePlayer::PostThink in the batch mode.
+* The handler is called once per frame with all the players which have thought during the frame.
+*
+* @note The callback is executed at the start of next frame, its prototype: public callback(const players[], const count)
+* @note Players are filtered at the time of the call.
+*
+* @param function   RG_CBasePlayer_PreThink or RG_CBasePlayer_PostThink
+* @param callback   The forward to call
+* @param filter     Filter of players, look at the enum ThinkBatchFilter
+* @param team       Pass only players of this team, TEAM_UNASSIGNED to pass all teams
+*
+* @return           Returns a hook handle. Use EnableHookChain/DisableHookChain to toggle the forward on or off
+*
+* native HookChain:RegisterHookChainBatch(any:function_id, const callback[], filter = TBF_NONE, TeamName:team = TEAM_UNASSIGNED);
+*/
+cell AMX_NATIVE_CALL RegisterHookChainBatch(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_func, arg_handler, arg_filter, arg_team };
+
 	int func = params[arg_func];
-	int post = params[arg_post];
-	auto hook = g_hookManager.getHook(func);
 
-	if (unlikely(hook == nullptr))
+	CThinkBatch::batch_e type;
+	switch (func)
 	{
-		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: function with id (%d) doesn't exist in current API version.", __FUNCTION__, func);
+	case RG_CBasePlayer_PreThink:
+		type = CThinkBatch::BATCH_PRETHINK;
+		break;
+	case RG_CBasePlayer_PostThink:
+		type = CThinkBatch::BATCH_POSTTHINK;
+		break;
+	default:
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: function with id (%d) can't be hooked in the batch mode.", __FUNCTION__, func);
 		return INVALID_HOOKCHAIN;
 	}
 
+	auto hook = g_hookManager.getHook(func);
 	if (unlikely(!hook->checkRequirements()))
 	{
 		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: function (%s) is not available, %s required.", __FUNCTION__, hook->func_name, hook->depend_name);
@@ -42,14 +131,16 @@ cell AMX_NATIVE_CALL RegisterHookChain(AMX *amx, cell *params)
 		return INVALID_HOOKCHAIN;
 	}
 
-	int fwid = hook->registerForward(amx, funcname);
+	int fwid = g_amxxapi.RegisterSPForwardByName(amx, funcname, FP_ARRAY, FP_CELL, FP_DONE);
 	if (unlikely(fwid == -1))
 	{
 		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: register forward failed.", __FUNCTION__);
 		return INVALID_HOOKCHAIN;
 	}
 
-	return g_hookManager.addHandler(amx, func, funcname, fwid, post != 0);
+	cell handle = g_hookManager.addHandler(amx, func, funcname, fwid, true, FMODE_BATCH);
+	g_thinkBatch.Add(type, handle, params[arg_filter], static_cast<TeamName>(params[arg_team]));
+	return handle;
 }
 
 /*
@@ -285,7 +376,7 @@ cell AMX_NATIVE_CALL SetHookChainArg(AMX *amx, cell *params)
 		return FALSE;
 	}
 
-	AType type = g_hookCtx->args[number].type;
+	AType type = g_hookCtx->getArgType(number);
 	if (unlikely(params[arg_type] != type))
 	{
 		AMXX_LogError(amx, AMX_ERR_NATIVE,
@@ -299,7 +390,7 @@ cell AMX_NATIVE_CALL SetHookChainArg(AMX *amx, cell *params)
 	}
 
 	cell* srcAddr = getAmxAddr(amx, params[arg_value]);
-	size_t destAddr = g_hookCtx->args[number].handle;
+	size_t destAddr = g_hookCtx->getArgHandle(number);
 
 	switch (type)
 	{
@@ -311,8 +402,14 @@ cell AMX_NATIVE_CALL SetHookChainArg(AMX *amx, cell *params)
 		*(bool *)destAddr = *srcAddr != 0;
 		break;
 	case ATYPE_STRING:
-		*(char **)destAddr = getAmxString(srcAddr, g_hookCtx->get_temp_string(amx), CTempStrings::STRING_LEN);
+	{
+		size_t len = 0;
+		while (srcAddr[len] && len < CTempStrings::STRING_LEN)
+			len++;
+
+		*(char **)destAddr = getAmxString(srcAddr, g_hookCtx->get_temp_string(len + 1), len + 1);
 		break;
+	}
 	case ATYPE_CLASSPTR:
 		*(CBaseEntity **)destAddr = getPrivate<CBaseEntity>(*srcAddr);
 		break;
@@ -325,6 +422,9 @@ cell AMX_NATIVE_CALL SetHookChainArg(AMX *amx, cell *params)
 	case ATYPE_TRACE:
 		**(TraceResult **)destAddr = *(TraceResult *)(*srcAddr);
 		break;
+	case ATYPE_VECTOR:
+		*((amxvector_t *)destAddr)->vec = *(Vector *)srcAddr;
+		break;
 	default:
 		return FALSE;
 	}
@@ -385,6 +485,8 @@ cell AMX_NATIVE_CALL GetCurrentHookChainHandle(AMX* amx, cell* params)
 AMX_NATIVE_INFO HookChain_Natives[] =
 {
 	{ "RegisterHookChain", RegisterHookChain },
+	{ "RegisterHookChainDeferred", RegisterHookChainDeferred },
+	{ "RegisterHookChainBatch", RegisterHookChainBatch },
 
 	{ "EnableHookChain", EnableHookChain },
 	{ "DisableHookChain", DisableHookChain },
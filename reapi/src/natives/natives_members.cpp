@@ -816,6 +816,84 @@ cell AMX_NATIVE_CALL get_rebuy(AMX *amx, cell *params)
 	return get_member(amx, handle, member, nullptr, 0);
 }
 
+/*
+* Saves entvars and private members of the entity into a snapshot.
+* @note Only plain data is saved, references to other entities aren't restored.
+*
+* @param index      Entity index
+*
+* @return           Snapshot handle
+*
+* native EntitySnapshot:create_snapshot(const index);
+*/
+cell AMX_NATIVE_CALL create_snapshot(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_index };
+
+	CHECK_ISENTITY(arg_index);
+
+	edict_t *pEdict = edictByIndex(params[arg_index]);
+	if (unlikely(pEdict->free || pEdict->pvPrivateData == nullptr)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid or uninitialized entity", __FUNCTION__);
+		return FALSE;
+	}
+
+	return g_entitySnapshots.Create(pEdict);
+}
+
+/*
+* Restores the entity from a snapshot.
+*
+* @param snapshot   Snapshot handle
+* @param index      Entity index, 0 to restore the entity of the snapshot
+*
+* @return           1 on success, 0 if the entity isn't of the same class
+*
+* native restore_snapshot(const EntitySnapshot:snapshot, const index = 0);
+*/
+cell AMX_NATIVE_CALL restore_snapshot(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_snapshot, arg_index };
+
+	if (unlikely(!g_entitySnapshots.IsValid(params[arg_snapshot]))) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid snapshot handle %i", __FUNCTION__, params[arg_snapshot]);
+		return FALSE;
+	}
+
+	CHECK_ISENTITY(arg_index);
+
+	int index = params[arg_index] ? params[arg_index] : g_entitySnapshots.GetEntity(params[arg_snapshot]);
+
+	edict_t *pEdict = edictByIndex(index);
+	if (unlikely(pEdict->free || pEdict->pvPrivateData == nullptr)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid or uninitialized entity", __FUNCTION__);
+		return FALSE;
+	}
+
+	return g_entitySnapshots.Restore(params[arg_snapshot], pEdict) ? TRUE : FALSE;
+}
+
+/*
+* Frees a snapshot.
+*
+* @param snapshot   Snapshot handle, will be set to 0
+*
+* @return           1 on success, 0 otherwise
+*
+* native free_snapshot(&EntitySnapshot:snapshot);
+*/
+cell AMX_NATIVE_CALL free_snapshot(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_snapshot };
+
+	cell *snapshot = getAmxAddr(amx, params[arg_snapshot]);
+	if (!g_entitySnapshots.Remove(*snapshot))
+		return FALSE;
+
+	*snapshot = 0;
+	return TRUE;
+}
+
 AMX_NATIVE_INFO EngineVars_Natives[] =
 {
 	{ "set_entvar", set_entvar },
@@ -847,6 +925,10 @@ AMX_NATIVE_INFO ReGameVars_Natives[] =
 	{ "set_movevar", set_movevar },
 	{ "get_movevar", get_movevar },
 
+	{ "create_snapshot",  create_snapshot  },
+	{ "restore_snapshot", restore_snapshot },
+	{ "free_snapshot",    free_snapshot    },
+
 	{ "set_pmtrace", set_pmtrace },
 	{ "get_pmtrace", get_pmtrace },
 
@@ -215,6 +215,50 @@ cell AMX_NATIVE_CALL rg_dmg_radius(AMX *amx, cell *params)
 	return TRUE;
 }
 
+/*
+* Inflicts damage in a radius from the source position, looking up the entities through a spatial grid.
+* @note By default the damage works as rg_dmg_radius: it goes through the walls, the falloff is measured
+*       to the origin of entity (to the center for func_breakable) and the entities take it by TakeDamage.
+* @note With the flags the entities are traced, they are culled before any trace and the nearest ones are traced first.
+*
+* @param vecSrc             The source position
+* @param inflictor          Inflictor is the entity that caused the damage (such as a gun)
+* @param attacker           Attacker is the entity that triggered the damage (such as the gun's owner)
+* @param flDamage           The amount of damage
+* @param flRadius           Damage radius
+* @param iClassIgnore       To specify classes that are immune to damage
+* @param bitsDamageType     Damage type DMG_*
+* @param ignoreTeam         Players of the team don't take damage, TEAM_UNASSIGNED to damage all
+* @param ignoreClass        Entities of the classname don't take damage, "" to damage all
+* @param maxTraces          Max count of the traces, 0 is unlimited (used with the flags)
+* @param flags              Radius damage flags, look at the enum RadiusDamageFlags
+*
+* @return                   Count of the damaged entities
+*
+* native rg_dmg_radius_ex(Float:vecSrc[3], const inflictor, const attacker, const Float:flDamage, const Float:flRadius, const iClassIgnore, const bitsDamageType, const TeamName:ignoreTeam = TEAM_UNASSIGNED, const ignoreClass[] = "", const maxTraces = 0, const RadiusDamageFlags:flags = RDF_NONE);
+*/
+cell AMX_NATIVE_CALL rg_dmg_radius_ex(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_vec, arg_inflictor, arg_attacker, arg_damage, arg_radius, arg_ignore_class, arg_dmg_type, arg_ignore_team, arg_ignore_classname, arg_max_traces, arg_flags };
+
+	CHECK_ISENTITY(arg_inflictor);
+	CHECK_ISENTITY(arg_attacker);
+
+	char classname[256];
+
+	radiusdamage_t options;
+	options.ignoreTeam = (TeamName)params[arg_ignore_team];
+	options.ignoreClass = getAmxString(amx, params[arg_ignore_classname], classname);
+	options.maxTraces = max(0, params[arg_max_traces]);
+	options.flags = (PARAMS_COUNT >= arg_flags) ? params[arg_flags] : RDF_NONE;
+
+	if (!options.ignoreClass[0])
+		options.ignoreClass = nullptr;
+
+	CAmxArgs args(amx, params);
+	return RadiusDamageEx(args[arg_vec], args[arg_inflictor], args[arg_attacker], args[arg_damage], args[arg_radius], args[arg_ignore_class], args[arg_dmg_type], options);
+}
+
 /*
 * Resets the global multi damage accumulator.
 *
@@ -281,6 +325,135 @@ cell AMX_NATIVE_CALL rg_multidmg_add(AMX *amx, cell *params)
 	return TRUE;
 }
 
+// validates the victims of the batch at once, before any damage is added
+static bool checkMultiDamageVictims(AMX *amx, const char *funcname, const cell *victims, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		if (unlikely(victims[i] < 0 || victims[i] > gpGlobals->maxEntities)) {
+			AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid victim index %i at %u", funcname, victims[i], i);
+			return false;
+		}
+
+		if (unlikely(getPrivate<CBaseEntity>(victims[i]) == nullptr)) {
+			AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: victim %i at %u is uninitialized", funcname, victims[i], i);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+* Adds the batch of damages to the accumulator, same as rg_multidmg_add for each element.
+*
+* @param inflictor          Inflictor is the entity that caused the damage (such as a gun)
+* @param victims            The victims that take damage
+* @param flDamages          The amounts of damage
+* @param bitsDamageTypes    Damage types DMG_*
+* @param count              Count of the elements
+*
+* @noreturn
+*
+* native rg_multidmg_add_batch(const inflictor, const victims[], const Float:flDamages[], const bitsDamageTypes[], const count);
+*/
+cell AMX_NATIVE_CALL rg_multidmg_add_batch(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_inflictor, arg_victims, arg_damages, arg_dmg_types, arg_elements };
+
+	CHECK_ISENTITY(arg_inflictor);
+
+	size_t count = max(0, params[arg_elements]);
+	cell *victims = getAmxAddr(amx, params[arg_victims]);
+	float *damages = (float *)getAmxAddr(amx, params[arg_damages]);
+	cell *types = getAmxAddr(amx, params[arg_dmg_types]);
+
+	if (!checkMultiDamageVictims(amx, __FUNCTION__, victims, count))
+		return FALSE;
+
+	CAmxArgs args(amx, params);
+	entvars_t *pevInflictor = args[arg_inflictor];
+
+	for (size_t i = 0; i < count; i++)
+		g_ReGameFuncs->AddMultiDamage(pevInflictor, getPrivate<CBaseEntity>(victims[i]), damages[i], types[i]);
+
+	return TRUE;
+}
+
+/*
+* Inflicts the batch of damages, summed up per victim.
+* @note Each victim goes through ApplyMultiDamage once, whatever count of damages it has in the batch.
+* @note The damage already added by rg_multidmg_add is applied first with the same inflictor and attacker,
+*       as the game does when the damage of another victim is added.
+*
+* @param inflictor          Inflictor is the entity that caused the damage (such as a gun)
+* @param attacker           Attacker is the entity that triggered the damage (such as the gun's owner)
+* @param victims            The victims that take damage
+* @param flDamages          The amounts of damage
+* @param bitsDamageTypes    Damage types DMG_*
+* @param count              Count of the elements
+*
+* @noreturn
+*
+* native rg_multidmg_apply_batch(const inflictor, const attacker, const victims[], const Float:flDamages[], const bitsDamageTypes[], const count);
+*/
+cell AMX_NATIVE_CALL rg_multidmg_apply_batch(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_inflictor, arg_attacker, arg_victims, arg_damages, arg_dmg_types, arg_elements };
+
+	CHECK_ISENTITY(arg_inflictor);
+	CHECK_ISENTITY(arg_attacker);
+
+	size_t count = max(0, params[arg_elements]);
+	cell *victims = getAmxAddr(amx, params[arg_victims]);
+	float *damages = (float *)getAmxAddr(amx, params[arg_damages]);
+	cell *types = getAmxAddr(amx, params[arg_dmg_types]);
+
+	if (!checkMultiDamageVictims(amx, __FUNCTION__, victims, count))
+		return FALSE;
+
+	struct victim_t
+	{
+		cell index;
+		float damage;
+		int types;
+	};
+
+	// sum up the damage of each victim in order of the first hit
+	std::vector<victim_t> summed;
+	summed.reserve(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		auto iter = std::find_if(summed.begin(), summed.end(), [&](const victim_t &victim) { return victim.index == victims[i]; });
+		if (iter != summed.end()) {
+			iter->damage += damages[i];
+			iter->types |= types[i];
+			continue;
+		}
+
+		summed.push_back({ victims[i], damages[i], types[i] });
+	}
+
+	CAmxArgs args(amx, params);
+	entvars_t *pevInflictor = args[arg_inflictor];
+	entvars_t *pevAttacker = args[arg_attacker];
+
+	// the pending damage of the accumulator goes first,
+	// AddMultiDamage applies the previous victim on its own, so clear after each one
+	g_ReGameFuncs->ApplyMultiDamage(pevInflictor, pevAttacker);
+	g_ReGameFuncs->ClearMultiDamage();
+
+	for (auto &victim : summed)
+	{
+		g_ReGameFuncs->AddMultiDamage(pevInflictor, getPrivate<CBaseEntity>(victim.index), victim.damage, victim.types);
+		g_ReGameFuncs->ApplyMultiDamage(pevInflictor, pevAttacker);
+		g_ReGameFuncs->ClearMultiDamage();
+	}
+
+	return TRUE;
+}
+
 /*
 * Fires bullets from entity.
 *
@@ -416,6 +589,106 @@ cell AMX_NATIVE_CALL rg_fire_bullets3(AMX *amx, cell *params)
 	return TRUE;
 }
 
+/*
+* Fires the batch of rays and applies the damage of all hits at once.
+* @note The rays don't penetrate, the damage is accumulated through TraceAttack
+*       and applied by a single rg_multidmg_apply call.
+*
+* @param inflictor          Inflictor is the entity that caused the damage (such as a gun)
+* @param attacker           Attacker is the entity that triggered the damage (such as the gun's owner)
+* @param vecSrc             The source position of the barrel
+* @param vecDirShooting     Shooting direction
+* @param vecSpreads         Spread of each ray, pairs of right and up offsets
+* @param rays               Count of the rays, up to MAX_BATCH_RAYS; the arrays must have room for each ray
+* @param flDistance         Max shot distance
+* @param flDamage           Damage amount of each ray
+* @param flRangeModifier    Damage range modifier, damage is scaled by the modifier per 500 units
+* @param hitEnts            Array to store the hit entity of each ray in, -1 if nothing is hit
+* @param hitGroups          Array to store the hit group of each ray in
+* @param vecEndPos          Array to store the end position of each ray in, 3 cells per ray
+* @param flDamages          Array to store the damage of each ray in
+* @param bitsDamageType     Damage type DMG_*
+*
+* @return                   Count of the rays hit an entity that takes damage
+*
+* native rg_fire_bullets_batch(const inflictor, const attacker, const Float:vecSrc[3], const Float:vecDirShooting[3], const Float:vecSpreads[], const rays, const Float:flDistance, const Float:flDamage, const Float:flRangeModifier, hitEnts[], hitGroups[], Float:vecEndPos[], Float:flDamages[], const bitsDamageType = DMG_BULLET | DMG_NEVERGIB);
+*/
+cell AMX_NATIVE_CALL rg_fire_bullets_batch(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_inflictor, arg_attacker, arg_vecSrc, arg_dir, arg_spreads, arg_rays, arg_dist, arg_dmg, arg_range_mod, arg_hit_ents, arg_hit_groups, arg_end_pos, arg_damages, arg_dmg_type };
+
+	CHECK_ISENTITY(arg_inflictor);
+	CHECK_ISENTITY(arg_attacker);
+
+	if (unlikely(params[arg_rays] <= 0 || params[arg_rays] > MAX_BATCH_RAYS)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid count of rays %i, must be 1 to %i", __FUNCTION__, params[arg_rays], MAX_BATCH_RAYS);
+		return FALSE;
+	}
+
+	CAmxArgs args(amx, params);
+	entvars_t *pevInflictor = args[arg_inflictor];
+	entvars_t *pevAttacker = args[arg_attacker];
+
+	Vector &vecSrc = args[arg_vecSrc];
+	Vector vecDir = args[arg_dir].vector().Normalize();
+	float flDistance = args[arg_dist];
+	float flDamage = args[arg_dmg];
+	float flRangeModifier = args[arg_range_mod];
+
+	float *spreads = (float *)getAmxAddr(amx, params[arg_spreads]);
+	cell *hitEnts = getAmxAddr(amx, params[arg_hit_ents]);
+	cell *hitGroups = getAmxAddr(amx, params[arg_hit_groups]);
+	Vector *endPos = (Vector *)getAmxAddr(amx, params[arg_end_pos]);
+	float *damages = (float *)getAmxAddr(amx, params[arg_damages]);
+
+	// the basis of the spread offsets
+	Vector vecRight = CrossProduct(vecDir, Vector(0, 0, 1));
+	if (vecRight.IsZero())
+		vecRight = Vector(0, -1, 0);
+
+	vecRight = vecRight.Normalize();
+	Vector vecUp = CrossProduct(vecRight, vecDir);
+
+	edict_t *pentSkip = pevAttacker ? pevAttacker->pContainingEntity : nullptr;
+	int hits = 0;
+
+	g_ReGameFuncs->ClearMultiDamage();
+
+	for (int ray = 0; ray < params[arg_rays]; ray++)
+	{
+		Vector vecRay = vecDir + vecRight * spreads[ray * 2] + vecUp * spreads[ray * 2 + 1];
+
+		TraceResult tr;
+		TRACE_LINE(vecSrc, vecSrc + vecRay * flDistance, dont_ignore_monsters, pentSkip, &tr);
+
+		hitEnts[ray] = AMX_NULLENT;
+		hitGroups[ray] = tr.iHitgroup;
+		endPos[ray] = tr.vecEndPos;
+		damages[ray] = 0;
+
+		if (tr.flFraction == 1.0f)
+			continue;
+
+		CBaseEntity *pEntity = getPrivate<CBaseEntity>(tr.pHit);
+		if (!pEntity)
+			continue;
+
+		hitEnts[ray] = indexOfEdict(tr.pHit);
+
+		if (pEntity->pev->takedamage == DAMAGE_NO)
+			continue;
+
+		float flCurrentDamage = flDamage * pow(flRangeModifier, (tr.vecEndPos - vecSrc).Length() / 500);
+		damages[ray] = flCurrentDamage;
+
+		pEntity->TraceAttack(pevAttacker, flCurrentDamage, vecRay, &tr, params[arg_dmg_type]);
+		hits++;
+	}
+
+	g_ReGameFuncs->ApplyMultiDamage(pevInflictor, pevAttacker);
+	return hits;
+}
+
 struct {
 	const char *msg;
 	const char *sentence;
@@ -2586,6 +2859,187 @@ cell AMX_NATIVE_CALL rg_get_can_hear_player(AMX* amx, cell* params)
 	return CSGameRules()->m_VoiceGameMgr.m_pHelper->GetCanHearPlayer(pListener, pSender);
 }
 
+#define CHECK_VOICE_LISTEN(x) if (unlikely(params[x] < VL_DEFAULT || params[x] > VL_HEAR)) { AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid listen state %i", __FUNCTION__, params[x]); return FALSE; }
+#define CHECK_VOICE_PRESET(x) if (unlikely(params[x] < 0 || params[x] >= MAX_VOICE_PRESETS)) { AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid preset %i", __FUNCTION__, params[x]); return FALSE; }
+
+/*
+* Sets if the listener hears the sender in the voice matrix.
+* @note The matrix is checked before CSGameRules::CanPlayerHearPlayer,
+*       the pairs left at VL_DEFAULT are decided by the game.
+*
+* @param listener              Listener player id
+* @param sender                Sender player id
+* @param listen                Listen state, see VL_* constants in reapi_gamedll_const.inc
+*
+* @noreturn
+*
+* native rg_voice_set_pair(const listener, const sender, const VoiceListen:listen);
+*/
+cell AMX_NATIVE_CALL rg_voice_set_pair(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_listener, arg_sender, arg_listen };
+
+	CHECK_ISPLAYER(arg_listener);
+	CHECK_ISPLAYER(arg_sender);
+	CHECK_VOICE_LISTEN(arg_listen);
+
+	g_voiceMatrix.SetPair(params[arg_listener], params[arg_sender], (VoiceListen)params[arg_listen]);
+	return TRUE;
+}
+
+/*
+* Gets if the listener hears the sender in the voice matrix.
+*
+* @param listener              Listener player id
+* @param sender                Sender player id
+*
+* @return                      Listen state, see VL_* constants in reapi_gamedll_const.inc
+*
+* native VoiceListen:rg_voice_get_pair(const listener, const sender);
+*/
+cell AMX_NATIVE_CALL rg_voice_get_pair(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_listener, arg_sender };
+
+	CHECK_ISPLAYER(arg_listener);
+	CHECK_ISPLAYER(arg_sender);
+
+	return g_voiceMatrix.GetPair(params[arg_listener], params[arg_sender]);
+}
+
+/*
+* Sets if the listener hears all senders (matrix row).
+*
+* @param listener              Listener player id
+* @param listen                Listen state, see VL_* constants in reapi_gamedll_const.inc
+*
+* @noreturn
+*
+* native rg_voice_set_listener(const listener, const VoiceListen:listen);
+*/
+cell AMX_NATIVE_CALL rg_voice_set_listener(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_listener, arg_listen };
+
+	CHECK_ISPLAYER(arg_listener);
+	CHECK_VOICE_LISTEN(arg_listen);
+
+	g_voiceMatrix.SetListener(params[arg_listener], (VoiceListen)params[arg_listen]);
+	return TRUE;
+}
+
+/*
+* Sets if all listeners hear the sender (matrix column).
+*
+* @param sender                Sender player id
+* @param listen                Listen state, see VL_* constants in reapi_gamedll_const.inc
+*
+* @noreturn
+*
+* native rg_voice_set_sender(const sender, const VoiceListen:listen);
+*/
+cell AMX_NATIVE_CALL rg_voice_set_sender(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_sender, arg_listen };
+
+	CHECK_ISPLAYER(arg_sender);
+	CHECK_VOICE_LISTEN(arg_listen);
+
+	g_voiceMatrix.SetSender(params[arg_sender], (VoiceListen)params[arg_listen]);
+	return TRUE;
+}
+
+/*
+* Sets if the players of the listener team hear the players of the sender team.
+* @note The teams are taken at the moment of the call.
+*
+* @param listener_team         Team of the listeners, TEAM_UNASSIGNED for all players
+* @param sender_team           Team of the senders, TEAM_UNASSIGNED for all players
+* @param listen                Listen state, see VL_* constants in reapi_gamedll_const.inc
+*
+* @noreturn
+*
+* native rg_voice_set_teams(const TeamName:listener_team, const TeamName:sender_team, const VoiceListen:listen);
+*/
+cell AMX_NATIVE_CALL rg_voice_set_teams(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_listener_team, arg_sender_team, arg_listen };
+
+	CHECK_VOICE_LISTEN(arg_listen);
+
+	g_voiceMatrix.SetTeams((TeamName)params[arg_listener_team], (TeamName)params[arg_sender_team], (VoiceListen)params[arg_listen]);
+	return TRUE;
+}
+
+/*
+* Mutes all dead players to the alive ones.
+* @note Checked before the pairs of the matrix.
+*
+* @param mute                  Mute dead players
+*
+* @noreturn
+*
+* native rg_voice_mute_dead(const bool:mute = true);
+*/
+cell AMX_NATIVE_CALL rg_voice_mute_dead(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_mute };
+
+	g_voiceMatrix.MuteDead(params[arg_mute] != 0);
+	return TRUE;
+}
+
+/*
+* Saves the voice matrix to the preset.
+*
+* @param preset                Preset number, 0 to 7
+*
+* @noreturn
+*
+* native rg_voice_save_preset(const preset);
+*/
+cell AMX_NATIVE_CALL rg_voice_save_preset(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_preset };
+
+	CHECK_VOICE_PRESET(arg_preset);
+
+	g_voiceMatrix.SavePreset(params[arg_preset]);
+	return TRUE;
+}
+
+/*
+* Copies the voice matrix from the preset.
+*
+* @param preset                Preset number, 0 to 7
+*
+* @noreturn
+*
+* native rg_voice_load_preset(const preset);
+*/
+cell AMX_NATIVE_CALL rg_voice_load_preset(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_preset };
+
+	CHECK_VOICE_PRESET(arg_preset);
+
+	g_voiceMatrix.LoadPreset(params[arg_preset]);
+	return TRUE;
+}
+
+/*
+* Resets the voice matrix, all pairs are decided by the game.
+*
+* @noreturn
+*
+* native rg_voice_reset();
+*/
+cell AMX_NATIVE_CALL rg_voice_reset(AMX *amx, cell *params)
+{
+	g_voiceMatrix.Reset();
+	return TRUE;
+}
+
 /*
 * Spawn a head gib
 *
@@ -3293,7 +3747,538 @@ cell AMX_NATIVE_CALL rg_player_relationship(AMX *amx, cell *params)
 	return CSGameRules()->PlayerRelationship(pPlayer, pTarget);
 }
 
-AMX_NATIVE_INFO Misc_Natives_RG[] =
+/*
+* Sets the movement modifier of the player.
+* @note The modifiers are applied inside PM_Move/PM_Jump hooks on each usercmd,
+*       so change them only when the player state changes.
+*
+* @param index      Client index
+* @param type       Modifier type, see MM_* constants in reapi_gamedll_const.inc
+* @param value      Modifier value
+*
+* @return           1 on success, 0 otherwise
+*
+* native rg_set_user_move_modifier(const index, const MoveModifier:type, any:value);
+*/
+cell AMX_NATIVE_CALL rg_set_user_move_modifier(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_index, arg_type, arg_value };
+
+	CHECK_ISPLAYER(arg_index);
+
+	if (unlikely(params[arg_type] < 0 || params[arg_type] >= MM_MAX)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: unknown modifier type %d", __FUNCTION__, params[arg_type]);
+		return FALSE;
+	}
+
+	CBasePlayer *pPlayer = UTIL_PlayerByIndex(params[arg_index]);
+	CHECK_CONNECTED(pPlayer, arg_index);
+
+	g_moveModifiers.Set(params[arg_index], (MoveModifier)params[arg_type], params[arg_value]);
+	return TRUE;
+}
+
+/*
+* Gets the movement modifier of the player.
+*
+* @param index      Client index
+* @param type       Modifier type, see MM_* constants in reapi_gamedll_const.inc
+*
+* @return           Modifier value, 0 if the modifier is not set
+*
+* native any:rg_get_user_move_modifier(const index, const MoveModifier:type);
+*/
+cell AMX_NATIVE_CALL rg_get_user_move_modifier(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_index, arg_type };
+
+	CHECK_ISPLAYER(arg_index);
+
+	if (unlikely(params[arg_type] < 0 || params[arg_type] >= MM_MAX)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: unknown modifier type %d", __FUNCTION__, params[arg_type]);
+		return FALSE;
+	}
+
+	return g_moveModifiers.Get(params[arg_index], (MoveModifier)params[arg_type]);
+}
+
+/*
+* Resets the movement modifiers of the player.
+*
+* @param index      Client index
+* @param type       Modifier type, see MM_* constants in reapi_gamedll_const.inc
+*
+* @return           1 on success, 0 otherwise
+*
+* native rg_reset_user_move_modifiers(const index, const MoveModifier:type = MM_ALL);
+*/
+cell AMX_NATIVE_CALL rg_reset_user_move_modifiers(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_index, arg_type };
+
+	CHECK_ISPLAYER(arg_index);
+
+	if (params[arg_type] == MM_ALL) {
+		g_moveModifiers.Reset(params[arg_index]);
+		return TRUE;
+	}
+
+	if (unlikely(params[arg_type] < 0 || params[arg_type] >= MM_MAX)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: unknown modifier type %d", __FUNCTION__, params[arg_type]);
+		return FALSE;
+	}
+
+	g_moveModifiers.Reset(params[arg_index], (MoveModifier)params[arg_type]);
+	return TRUE;
+}
+
+/*
+* Binds the array to the shared table of the player states.
+* @note The array is refreshed at the start of each server frame,
+*       reading the state of any player is a plain array access then.
+* @note The array must be global or static, local arrays are rejected.
+*
+* @param data       Array to fill, new data[MAX_PLAYERS + 1][PlayerState]
+* @param size       Size of the array
+*
+* @return           1 on success, 0 otherwise
+*
+* native rg_bind_player_state(data[][PlayerState], const size = sizeof(data));
+*/
+cell AMX_NATIVE_CALL rg_bind_player_state(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_data, arg_size };
+
+	if (unlikely(params[arg_size] < gpGlobals->maxClients + 1)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: array must have at least %i rows", __FUNCTION__, gpGlobals->maxClients + 1);
+		return FALSE;
+	}
+
+	// the array is written on each frame, so it has to live as long as the plugin
+	AMX_HEADER *hdr = (AMX_HEADER *)amx->base;
+	cell dataSize = hdr->hea - hdr->dat;
+	if (unlikely(params[arg_data] < 0 || params[arg_data] + params[arg_size] * (cell)sizeof(cell) > dataSize)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: array must be global or static", __FUNCTION__);
+		return FALSE;
+	}
+
+	// the rows should fit the state
+	cell *table = getAmxAddr(amx, params[arg_data]);
+	cell *row0 = (cell *)((uint8 *)&table[0] + table[0]);
+	cell *row1 = (cell *)((uint8 *)&table[1] + table[1]);
+	if (unlikely(size_t(row1 - row0) * sizeof(cell) < sizeof(CPlayerStates::state_t))) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: array rows must be of PlayerState size", __FUNCTION__);
+		return FALSE;
+	}
+
+	// the last row
+	cell lastRow = params[arg_data] + gpGlobals->maxClients * sizeof(cell) + table[gpGlobals->maxClients];
+	if (unlikely(lastRow < 0 || lastRow + (cell)sizeof(CPlayerStates::state_t) > dataSize)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: array must be global or static", __FUNCTION__);
+		return FALSE;
+	}
+
+	g_playerStates.Bind(amx, params[arg_data]);
+	return TRUE;
+}
+
+/*
+* Unbinds the array of the plugin from the shared table of the player states.
+*
+* @return           1 on success, 0 if nothing was bound
+*
+* native rg_unbind_player_state();
+*/
+cell AMX_NATIVE_CALL rg_unbind_player_state(AMX *amx, cell *params)
+{
+	return g_playerStates.Unbind(amx) ? TRUE : FALSE;
+}
+
+/*
+* Creates an entity template, the entities are spawned from it by rg_spawn_from_template.
+* @note The templates are freed on map change.
+*
+* @param classname      Entity classname
+* @param useHashTable   Use this only for known game entities, see rg_create_entity
+*
+* @return               Template handle
+*
+* native EntityTemplate:rg_create_template(const classname[], const bool:useHashTable = false);
+*/
+cell AMX_NATIVE_CALL rg_create_template(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_classname, arg_hashtable };
+
+	char classname[256];
+	getAmxString(amx, params[arg_classname], classname);
+
+	return g_entityTemplates.Create(classname, params[arg_hashtable] != 0);
+}
+
+/*
+* Frees the entity template, the spawned entities are kept.
+*
+* @param template   Template handle, will be set to 0
+*
+* @return           1 on success, 0 otherwise
+*
+* native rg_free_template(&EntityTemplate:template);
+*/
+cell AMX_NATIVE_CALL rg_free_template(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_template };
+
+	cell *handle = getAmxAddr(amx, params[arg_template]);
+	if (!g_entityTemplates.Remove(*handle))
+		return FALSE;
+
+	*handle = 0;
+	return TRUE;
+}
+
+/*
+* Sets the model of the entities spawned from the template.
+* @note The model must be precached.
+*
+* @param template   Template handle
+* @param model      Model path, empty to spawn without model
+*
+* @return           1 on success, 0 otherwise
+*
+* native rg_template_set_model(const EntityTemplate:template, const model[]);
+*/
+cell AMX_NATIVE_CALL rg_template_set_model(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_template, arg_model };
+
+	if (unlikely(!g_entityTemplates.IsValid(params[arg_template]))) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid template handle %i", __FUNCTION__, params[arg_template]);
+		return FALSE;
+	}
+
+	char model[MAX_PATH];
+	g_entityTemplates.SetModel(params[arg_template], getAmxString(amx, params[arg_model], model));
+	return TRUE;
+}
+
+/*
+* Sets the size of the entities spawned from the template, it's applied after the model.
+*
+* @param template   Template handle
+* @param mins       Mins of the size
+* @param maxs       Maxs of the size
+*
+* @return           1 on success, 0 otherwise
+*
+* native rg_template_set_size(const EntityTemplate:template, const Float:mins[3], const Float:maxs[3]);
+*/
+cell AMX_NATIVE_CALL rg_template_set_size(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_template, arg_mins, arg_maxs };
+
+	if (unlikely(!g_entityTemplates.IsValid(params[arg_template]))) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid template handle %i", __FUNCTION__, params[arg_template]);
+		return FALSE;
+	}
+
+	CAmxArgs args(amx, params);
+	g_entityTemplates.SetSize(params[arg_template], args[arg_mins], args[arg_maxs]);
+	return TRUE;
+}
+
+/*
+* Sets entvar of the entities spawned from the template, e.g. var_movetype or var_solid.
+* @note The value is converted once, the spawn copies it to the entity.
+* @note Entity references aren't supported, set them after the spawn.
+*
+* @param template   Template handle
+* @param var        The specified entvar, look at the enum EntVars
+*
+* @return           1 on success, 0 otherwise
+*
+* native rg_template_set_entvar(const EntityTemplate:template, const EntVars:var, any:...);
+*/
+cell AMX_NATIVE_CALL rg_template_set_entvar(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_template, arg_var, arg_value, arg_elem };
+
+	if (unlikely(!g_entityTemplates.IsValid(params[arg_template]))) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid template handle %i", __FUNCTION__, params[arg_template]);
+		return FALSE;
+	}
+
+	if (unlikely(memberlist[params[arg_var]] == nullptr || params[arg_var] / MAX_REGION_RANGE != memberlist_t::mt_entvars)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: unknown entvar id %i", __FUNCTION__, params[arg_var]);
+		return FALSE;
+	}
+
+	cell *value = getAmxAddr(amx, params[arg_value]);
+	size_t element = (PARAMS_COUNT == 4) ? *getAmxAddr(amx, params[arg_elem]) : 0;
+
+	return g_entityTemplates.SetField(amx, params[arg_template], params[arg_var], value, element) ? TRUE : FALSE;
+}
+
+/*
+* Sets member of the entities spawned from the template.
+* @note The value is converted once, the spawn copies it to the entity.
+* @note Entity references aren't supported, set them after the spawn.
+*
+* @param template   Template handle
+* @param member     The specified member, look at the enums with name *_Members
+*
+* @return           1 on success, 0 otherwise
+*
+* native rg_template_set_member(const EntityTemplate:template, any:member, any:...);
+*/
+cell AMX_NATIVE_CALL rg_template_set_member(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_template, arg_member, arg_value, arg_elem };
+
+	if (unlikely(!g_entityTemplates.IsValid(params[arg_template]))) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid template handle %i", __FUNCTION__, params[arg_template]);
+		return FALSE;
+	}
+
+	if (unlikely(memberlist[params[arg_member]] == nullptr)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: unknown member id %i", __FUNCTION__, params[arg_member]);
+		return FALSE;
+	}
+
+	cell *value = getAmxAddr(amx, params[arg_value]);
+	size_t element = (PARAMS_COUNT == 4) ? *getAmxAddr(amx, params[arg_elem]) : 0;
+
+	return g_entityTemplates.SetField(amx, params[arg_template], params[arg_member], value, element) ? TRUE : FALSE;
+}
+
+/*
+* Sets Think callback of the entities spawned from the template, see SetThink.
+*
+* @param template   Template handle
+* @param callback   The forward to call, "" to reset
+* @param delay      Delay of the first think after the spawn
+* @param params     Optional set of data to pass through to callback
+* @param len        Optional size of data
+*
+* @return           1 on success, 0 otherwise
+*
+* native rg_template_set_think(const EntityTemplate:template, const callback[], const Float:delay = 0.0, const params[] = "", const len = 0);
+*/
+cell AMX_NATIVE_CALL rg_template_set_think(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_template, arg_handler, arg_delay, arg_params, arg_len };
+
+	if (unlikely(!g_entityTemplates.IsValid(params[arg_template]))) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid template handle %i", __FUNCTION__, params[arg_template]);
+		return FALSE;
+	}
+
+	char namebuf[256];
+	const char *funcname = getAmxString(amx, params[arg_handler], namebuf);
+
+	int funcid;
+	if (unlikely(funcname[0] != '\0' && g_amxxapi.amx_FindPublic(amx, funcname, &funcid) != AMX_ERR_NONE)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: public function \"%s\" not found.", __FUNCTION__, funcname);
+		return FALSE;
+	}
+
+	CAmxArgs args(amx, params);
+	cell *pParams = getAmxAddr(amx, params[arg_params]);
+	return g_entityTemplates.SetCallback(amx, params[arg_template], CEntityCallbackDispatcher::Think, funcname, pParams, params[arg_len], args[arg_delay]) ? TRUE : FALSE;
+}
+
+/*
+* Sets Touch callback of the entities spawned from the template, see SetTouch.
+*
+* @param template   Template handle
+* @param callback   The forward to call, "" to reset
+* @param params     Optional set of data to pass through to callback
+* @param len        Optional size of data
+*
+* @return           1 on success, 0 otherwise
+*
+* native rg_template_set_touch(const EntityTemplate:template, const callback[], const params[] = "", const len = 0);
+*/
+cell AMX_NATIVE_CALL rg_template_set_touch(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_template, arg_handler, arg_params, arg_len };
+
+	if (unlikely(!g_entityTemplates.IsValid(params[arg_template]))) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid template handle %i", __FUNCTION__, params[arg_template]);
+		return FALSE;
+	}
+
+	char namebuf[256];
+	const char *funcname = getAmxString(amx, params[arg_handler], namebuf);
+
+	int funcid;
+	if (unlikely(funcname[0] != '\0' && g_amxxapi.amx_FindPublic(amx, funcname, &funcid) != AMX_ERR_NONE)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: public function \"%s\" not found.", __FUNCTION__, funcname);
+		return FALSE;
+	}
+
+	cell *pParams = getAmxAddr(amx, params[arg_params]);
+	return g_entityTemplates.SetCallback(amx, params[arg_template], CEntityCallbackDispatcher::Touch, funcname, pParams, params[arg_len]) ? TRUE : FALSE;
+}
+
+/*
+* Spawns an entity from the template.
+* @note The model, size, entvars, members and callbacks of the template are applied at once,
+*       then the entity is placed at the origin.
+*
+* @param template   Template handle
+* @param origin     Origin of the entity
+* @param angles     Angles of the entity
+* @param owner      Owner of the entity, 0 for none
+*
+* @return           Index of the created entity or 0 otherwise
+*
+* native rg_spawn_from_template(const EntityTemplate:template, const Float:origin[3], const Float:angles[3] = {0.0, 0.0, 0.0}, const owner = 0);
+*/
+cell AMX_NATIVE_CALL rg_spawn_from_template(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_template, arg_origin, arg_angles, arg_owner };
+
+	if (unlikely(!g_entityTemplates.IsValid(params[arg_template]))) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid template handle %i", __FUNCTION__, params[arg_template]);
+		return FALSE;
+	}
+
+	CHECK_ISENTITY(arg_owner);
+
+	CAmxArgs args(amx, params);
+	edict_t *pOwner = params[arg_owner] > 0 ? edictByIndex(params[arg_owner]) : nullptr;
+
+	edict_t *pEntity = g_entityTemplates.Spawn(params[arg_template], args[arg_origin], args[arg_angles], pOwner);
+	return pEntity ? indexOfEdict(pEntity) : 0;
+}
+
+/*
+* Creates a pool of hidden entities spawned from the template.
+* @note The released or removed entities of the pool are reset in place and kept hidden,
+*       their edicts are never freed and given to other entities.
+* @note The template has to be kept while the pool is used. The pools are freed on map change.
+* @note Requires ReHLDS.
+*
+* @param template   Template handle
+* @param count      Count of the entities
+*
+* @return           Pool handle, 0 if no entity could be spawned
+*
+* native EntityPool:rg_create_entity_pool(const EntityTemplate:template, const count);
+*/
+cell AMX_NATIVE_CALL rg_create_entity_pool(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_template, arg_size };
+
+	if (unlikely(!api_cfg.hasReHLDS())) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: isn't available without ReHlds", __FUNCTION__);
+		return FALSE;
+	}
+
+	if (unlikely(!g_entityTemplates.IsValid(params[arg_template]))) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid template handle %i", __FUNCTION__, params[arg_template]);
+		return FALSE;
+	}
+
+	if (unlikely(params[arg_size] <= 0 || params[arg_size] > gpGlobals->maxEntities)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid count of entities %i", __FUNCTION__, params[arg_size]);
+		return FALSE;
+	}
+
+	return g_entityPools.Create(params[arg_template], params[arg_size]);
+}
+
+/*
+* Frees the pool, the hidden entities are removed and the acquired ones are left to the plugin.
+*
+* @param pool       Pool handle, will be set to 0
+*
+* @return           1 on success, 0 otherwise
+*
+* native rg_free_entity_pool(&EntityPool:pool);
+*/
+cell AMX_NATIVE_CALL rg_free_entity_pool(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_pool };
+
+	cell *handle = getAmxAddr(amx, params[arg_pool]);
+	if (!g_entityPools.Remove(*handle))
+		return FALSE;
+
+	*handle = 0;
+	return TRUE;
+}
+
+/*
+* Takes an entity from the pool, it gets the state of the template and is placed at the origin.
+*
+* @param pool       Pool handle
+* @param origin     Origin of the entity
+* @param angles     Angles of the entity
+* @param owner      Owner of the entity, 0 for none
+*
+* @return           Entity index, 0 if the pool is empty
+*
+* native rg_entity_pool_acquire(const EntityPool:pool, const Float:origin[3], const Float:angles[3] = {0.0, 0.0, 0.0}, const owner = 0);
+*/
+cell AMX_NATIVE_CALL rg_entity_pool_acquire(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_pool, arg_origin, arg_angles, arg_owner };
+
+	if (unlikely(!g_entityPools.IsValid(params[arg_pool]))) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid pool handle %i", __FUNCTION__, params[arg_pool]);
+		return FALSE;
+	}
+
+	CHECK_ISENTITY(arg_owner);
+
+	CAmxArgs args(amx, params);
+	edict_t *pOwner = params[arg_owner] > 0 ? edictByIndex(params[arg_owner]) : nullptr;
+
+	edict_t *pEntity = g_entityPools.Acquire(params[arg_pool], args[arg_origin], args[arg_angles], pOwner);
+	return pEntity ? indexOfEdict(pEntity) : 0;
+}
+
+/*
+* Returns the entity to its pool, same as removing it.
+*
+* @param index      Entity index
+*
+* @return           1 on success, 0 if the entity isn't pooled
+*
+* native rg_entity_pool_release(const index);
+*/
+cell AMX_NATIVE_CALL rg_entity_pool_release(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_index };
+
+	CHECK_ISENTITY(arg_index);
+
+	return g_entityPools.Release(edictByIndex(params[arg_index])) ? TRUE : FALSE;
+}
+
+/*
+* Returns the count of the hidden entities left in the pool.
+*
+* @param pool       Pool handle
+*
+* @return           Count of the entities
+*
+* native rg_entity_pool_free_count(const EntityPool:pool);
+*/
+cell AMX_NATIVE_CALL rg_entity_pool_free_count(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_pool };
+
+	if (unlikely(!g_entityPools.IsValid(params[arg_pool]))) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid pool handle %i", __FUNCTION__, params[arg_pool]);
+		return FALSE;
+	}
+
+	return g_entityPools.GetFreeCount(params[arg_pool]);
+}
+
+AMX_NATIVE_INFO Misc_Natives_RG[] =
 {
 	{ "rg_set_animation",             rg_set_animation             },
 	{ "rg_add_account",               rg_add_account               },
@@ -3303,13 +4288,17 @@ AMX_NATIVE_INFO Misc_Natives_RG[] =
 	{ "rg_give_shield",               rg_give_shield               },
 
 	{ "rg_dmg_radius",                rg_dmg_radius                },
+	{ "rg_dmg_radius_ex",             rg_dmg_radius_ex             },
 	{ "rg_multidmg_clear",            rg_multidmg_clear            },
 	{ "rg_multidmg_apply",            rg_multidmg_apply            },
 	{ "rg_multidmg_add",              rg_multidmg_add              },
+	{ "rg_multidmg_add_batch",        rg_multidmg_add_batch        },
+	{ "rg_multidmg_apply_batch",      rg_multidmg_apply_batch      },
 
 	{ "rg_fire_bullets",              rg_fire_bullets              },
 	{ "rg_fire_buckshots",            rg_fire_buckshots            },
 	{ "rg_fire_bullets3",             rg_fire_bullets3             },
+	{ "rg_fire_bullets_batch",        rg_fire_bullets_batch        },
 
 	{ "rg_round_end",                 rg_round_end                 },
 	{ "rg_update_teamscores",         rg_update_teamscores         },
@@ -3386,6 +4375,16 @@ AMX_NATIVE_INFO Misc_Natives_RG[] =
 	{ "rg_set_can_hear_player",       rg_set_can_hear_player       },
 	{ "rg_get_can_hear_player",       rg_get_can_hear_player       },
 
+	{ "rg_voice_set_pair",            rg_voice_set_pair            },
+	{ "rg_voice_get_pair",            rg_voice_get_pair            },
+	{ "rg_voice_set_listener",        rg_voice_set_listener        },
+	{ "rg_voice_set_sender",          rg_voice_set_sender          },
+	{ "rg_voice_set_teams",           rg_voice_set_teams           },
+	{ "rg_voice_mute_dead",           rg_voice_mute_dead           },
+	{ "rg_voice_save_preset",         rg_voice_save_preset         },
+	{ "rg_voice_load_preset",         rg_voice_load_preset         },
+	{ "rg_voice_reset",               rg_voice_reset               },
+
 	{ "rg_spawn_head_gib",            rg_spawn_head_gib            },
 	{ "rg_spawn_random_gibs",         rg_spawn_random_gibs         },
 
@@ -3406,6 +4405,29 @@ AMX_NATIVE_INFO Misc_Natives_RG[] =
 	{ "rg_death_notice",              rg_death_notice              },
 	{ "rg_player_relationship",       rg_player_relationship       },
 
+	{ "rg_set_user_move_modifier",    rg_set_user_move_modifier    },
+	{ "rg_get_user_move_modifier",    rg_get_user_move_modifier    },
+	{ "rg_reset_user_move_modifiers", rg_reset_user_move_modifiers },
+
+	{ "rg_bind_player_state",         rg_bind_player_state         },
+	{ "rg_unbind_player_state",       rg_unbind_player_state       },
+
+	{ "rg_create_template",           rg_create_template           },
+	{ "rg_free_template",             rg_free_template             },
+	{ "rg_template_set_model",        rg_template_set_model        },
+	{ "rg_template_set_size",         rg_template_set_size         },
+	{ "rg_template_set_entvar",       rg_template_set_entvar       },
+	{ "rg_template_set_member",       rg_template_set_member       },
+	{ "rg_template_set_think",        rg_template_set_think        },
+	{ "rg_template_set_touch",        rg_template_set_touch        },
+	{ "rg_spawn_from_template",       rg_spawn_from_template       },
+
+	{ "rg_create_entity_pool",        rg_create_entity_pool        },
+	{ "rg_free_entity_pool",          rg_free_entity_pool          },
+	{ "rg_entity_pool_acquire",       rg_entity_pool_acquire       },
+	{ "rg_entity_pool_release",       rg_entity_pool_release       },
+	{ "rg_entity_pool_free_count",    rg_entity_pool_free_count    },
+
 	{ nullptr, nullptr }
 };
 
@@ -3614,6 +4636,213 @@ cell AMX_NATIVE_CALL rh_get_client_connect_time(AMX *amx, cell *params)
 	return (cell)(g_RehldsFuncs->GetRealTime() - pClient->netchan.connect_time);
 }
 
+/*
+* Starts copying the console output to the file, the lines are written by a background thread.
+* @note The tap keeps running over map changes, the call restarts it with the new settings.
+* @note The file is rotated when it gets bigger than maxsize, the old files are kept as file.1 ... file.N
+*
+* @param file       Path to the file relative to the mod directory
+* @param maxsize    Size of the file to rotate it in bytes, 0 to never rotate
+* @param maxfiles   Count of the old files to keep
+*
+* @return           true on success, false if the file can't be opened
+*
+* native bool:rh_log_tap_start(const file[], const maxsize = 0, const maxfiles = 5);
+*/
+cell AMX_NATIVE_CALL rh_log_tap_start(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_file, arg_maxsize, arg_maxfiles };
+
+	if (unlikely(params[arg_maxsize] < 0 || params[arg_maxfiles] < 0)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid size %d or count of files %d", __FUNCTION__, params[arg_maxsize], params[arg_maxfiles]);
+		return FALSE;
+	}
+
+	char filename[256], path[260];
+	getAmxString(amx, params[arg_file], filename);
+
+	return g_logTap.Start(g_amxxapi.BuildPathnameR(path, sizeof(path), "%s", filename), params[arg_maxsize], params[arg_maxfiles]) ? TRUE : FALSE;
+}
+
+/*
+* Stops copying the console output, the lines left are written before.
+*
+* @noreturn
+*
+* native rh_log_tap_stop();
+*/
+cell AMX_NATIVE_CALL rh_log_tap_stop(AMX *amx, cell *params)
+{
+	g_logTap.Stop();
+	return TRUE;
+}
+
+/*
+* Adds a filter of the console lines copied by the log tap.
+* @note The pattern supports * and ? wildcards and is matched against the whole line without the newline,
+*       e.g. "L *" for the log lines or "*error*" for the lines containing the word.
+* @note With include filters only the lines matching one of them are copied,
+*       the lines matching an exclude filter are never copied.
+*
+* @param pattern    Pattern of the line
+* @param exclude    Skip the matching lines instead
+*
+* @noreturn
+*
+* native rh_log_tap_add_filter(const pattern[], const bool:exclude = false);
+*/
+cell AMX_NATIVE_CALL rh_log_tap_add_filter(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_pattern, arg_exclude };
+
+	char pattern[256];
+	getAmxString(amx, params[arg_pattern], pattern);
+
+	g_logTap.AddFilter(pattern, params[arg_exclude] != 0);
+	return TRUE;
+}
+
+/*
+* Removes all filters of the log tap.
+*
+* @noreturn
+*
+* native rh_log_tap_clear_filters();
+*/
+cell AMX_NATIVE_CALL rh_log_tap_clear_filters(AMX *amx, cell *params)
+{
+	g_logTap.ClearFilters();
+	return TRUE;
+}
+
+/*
+* Adds a rule applied to the precache of the path, before the hooks of the plugins.
+* @note The rules are kept over map changes, the rule of the same path is replaced.
+* @note Blocked precache returns 0, don't block the models set to the entities.
+*
+* @param path           Path of the resource
+* @param replacement    Path precached instead, empty to block the precache
+*
+* @noreturn
+*
+* native rh_precache_add_rule(const path[], const replacement[] = "");
+*/
+cell AMX_NATIVE_CALL rh_precache_add_rule(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_path, arg_replacement };
+
+	char path[MAX_PATH], replacement[MAX_PATH];
+	getAmxString(amx, params[arg_path], path);
+	getAmxString(amx, params[arg_replacement], replacement);
+
+	g_precacheRegistry.AddRule(path, replacement);
+	return TRUE;
+}
+
+/*
+* Loads the precache rules from the file.
+* @note Each line is a path and the replacement separated by spaces, the path alone blocks the precache.
+*       The lines starting with ; # or // are comments.
+*
+* @param file       Path to the file relative to the mod directory
+*
+* @return           Count of the rules loaded, -1 if the file can't be opened
+*
+* native rh_precache_load_rules(const file[]);
+*/
+cell AMX_NATIVE_CALL rh_precache_load_rules(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_file };
+
+	char filename[256], path[260];
+	getAmxString(amx, params[arg_file], filename);
+
+	return g_precacheRegistry.LoadRules(g_amxxapi.BuildPathnameR(path, sizeof(path), "%s", filename));
+}
+
+/*
+* Removes all precache rules.
+*
+* @noreturn
+*
+* native rh_precache_clear_rules();
+*/
+cell AMX_NATIVE_CALL rh_precache_clear_rules(AMX *amx, cell *params)
+{
+	g_precacheRegistry.ClearRules();
+	return TRUE;
+}
+
+/*
+* Checks if the path is already precached on the current map.
+* @note The replaced paths are found by the original and the replacement path.
+*
+* @param path       Path of the resource
+* @param type       Type of the resource, look at the enum PrecacheType
+* @param index      Variable to store the precache index
+*
+* @return           true if precached, false otherwise
+*
+* native bool:rh_is_precached(const path[], const PrecacheType:type = PT_MODEL, &index = 0);
+*/
+cell AMX_NATIVE_CALL rh_is_precached(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_path, arg_type, arg_index };
+
+	if (unlikely(params[arg_type] < PT_MODEL || params[arg_type] >= PT_MAX)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid precache type %d", __FUNCTION__, params[arg_type]);
+		return FALSE;
+	}
+
+	char path[MAX_PATH];
+	getAmxString(amx, params[arg_path], path);
+
+	int index = g_precacheRegistry.GetIndex(PrecacheType(params[arg_type]), path);
+	if (index == -1)
+		return FALSE;
+
+	*getAmxAddr(amx, params[arg_index]) = index;
+	return TRUE;
+}
+
+/*
+* Remaps the classname resolved by GetEntityInit, the rule is applied before the hooks of the plugins.
+* @note Use it instead of hooking RH_GetEntityInit to replace the classes, the resolved
+*       entity factories are cached while no plugin hooks RH_GetEntityInit.
+* @note The rules are kept over map changes.
+*
+* @param classname  Classname of the created entity
+* @param target     Classname of the factory to use instead, empty to remove the rule
+*
+* @noreturn
+*
+* native rh_entity_init_remap(const classname[], const target[] = "");
+*/
+cell AMX_NATIVE_CALL rh_entity_init_remap(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_classname, arg_target };
+
+	char classname[256], target[256];
+	getAmxString(amx, params[arg_classname], classname);
+	getAmxString(amx, params[arg_target], target);
+
+	g_entityInitCache.SetRemap(classname, target);
+	return TRUE;
+}
+
+/*
+* Removes all classname remap rules of GetEntityInit.
+*
+* @noreturn
+*
+* native rh_entity_init_clear_remaps();
+*/
+cell AMX_NATIVE_CALL rh_entity_init_clear_remaps(AMX *amx, cell *params)
+{
+	g_entityInitCache.ClearRemaps();
+	return TRUE;
+}
+
 AMX_NATIVE_INFO Misc_Natives_RH[] =
 {
 	{ "rh_set_mapname",      rh_set_mapname      },
@@ -3626,6 +4855,19 @@ AMX_NATIVE_INFO Misc_Natives_RH[] =
 
 	{ "rh_get_client_connect_time", rh_get_client_connect_time },
 
+	{ "rh_log_tap_start",         rh_log_tap_start         },
+	{ "rh_log_tap_stop",          rh_log_tap_stop          },
+	{ "rh_log_tap_add_filter",    rh_log_tap_add_filter    },
+	{ "rh_log_tap_clear_filters", rh_log_tap_clear_filters },
+
+	{ "rh_precache_add_rule",    rh_precache_add_rule    },
+	{ "rh_precache_load_rules",  rh_precache_load_rules  },
+	{ "rh_precache_clear_rules", rh_precache_clear_rules },
+	{ "rh_is_precached",         rh_is_precached         },
+
+	{ "rh_entity_init_remap",        rh_entity_init_remap        },
+	{ "rh_entity_init_clear_remaps", rh_entity_init_clear_remaps },
+
 	{ nullptr, nullptr }
 };
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#define MAX_BATCH_RAYS 256 // rays of rg_fire_bullets_batch
+
 enum GiveType
 {
 	GT_APPEND,          // Just give item
@@ -39,6 +39,8 @@ cell AMX_NATIVE_CALL rg_get_nearest_nav_area(AMX *amx, cell *params)
 {
     enum args_e { arg_count, arg_origin, arg_anyz };
 
+    g_metrics.NavQuery();
+
     if(!g_ReGameFuncs->CheckNavigationmap())
     {
         AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: Navigation map is not loaded!", __FUNCTION__);
@@ -66,6 +68,8 @@ cell AMX_NATIVE_CALL rg_get_closest_point_in_area(AMX *amx, cell *params)
 {
     enum args_e { arg_count, arg_area, arg_origin, arg_position};
 
+    g_metrics.NavQuery();
+
     if(!g_ReGameFuncs->CheckNavigationmap())
     {
         AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: Navigation map is not loaded!", __FUNCTION__);
@@ -106,6 +110,8 @@ cell AMX_NATIVE_CALL rg_get_closest_point_in_area(AMX *amx, cell *params)
 cell AMX_NATIVE_CALL rg_compute_path(AMX* amx, cell *params)
 {
     enum args_e { arg_count, arg_entity, arg_data, arg_startarea, arg_vecstart, arg_goalarea, arg_vecgoal, arg_routetype };
+
+    g_metrics.NavQuery();
     
     if(!g_ReGameFuncs->CheckNavigationmap())
     {
@@ -466,6 +472,8 @@ cell AMX_NATIVE_CALL rg_update_path_movement(AMX *amx, cell *params)
 {
     enum args_e {  arg_count, arg_entity, arg_data, arg_tolerance, arg_check2d     };
 
+    g_metrics.NavQuery();
+
     if(!g_ReGameFuncs->CheckNavigationmap())
     {
         AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: Navigation map is not loaded!", __FUNCTION__);
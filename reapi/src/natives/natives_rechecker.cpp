@@ -52,6 +52,82 @@ cell AMX_NATIVE_CALL RegisterQueryFile(AMX *amx, cell *params)
 	return g_queryFileManager.Add(amx, filename, func, flag, params[arg_hash]);
 }
 
+/*
+* Send request the files for the client to get hashes, the results come to a single forward
+*
+* @param files          The files (Can contain a relative path to the file)
+* @param types          The request types of the files, can be only RES_TYPE_EXISTS, RES_TYPE_MISSING or RES_TYPE_HASH_ANY
+* @param hashes         Hashes of the files to request
+* @param count          Count of the files
+* @param function       The forward to call
+*
+* @note Callback should be contains passing arguments as "public QueryFiles_Callback(const client, const files[], const hashes[], const count)",
+*       files are indexes in the arrays of the registration, the responses of the client are collected and delivered once per frame
+*
+* @return               Returns a hook handle. Use UnRegisterQueryFile to unregister the forward
+*
+* native QueryFileHook:RegisterQueryFiles(const files[][], const ResourceType:types[], const hashes[], const count, const function[]);
+*/
+cell AMX_NATIVE_CALL RegisterQueryFiles(AMX *amx, cell *params)
+{
+	enum args_e { arg_count, arg_files, arg_types, arg_hashes, arg_size, arg_handler };
+
+	if (unlikely(params[arg_size] <= 0)) {
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid count of files %i.", __FUNCTION__, params[arg_size]);
+		return FALSE;
+	}
+
+	char funcname[256];
+	const char *func = getAmxString(amx, params[arg_handler], funcname);
+
+	int funcid;
+	if (unlikely(g_amxxapi.amx_FindPublic(amx, func, &funcid) != AMX_ERR_NONE))
+	{
+		AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: public function \"%s\" not found.", __FUNCTION__, func);
+		return FALSE;
+	}
+
+	cell *files = getAmxAddr(amx, params[arg_files]);
+	cell *types = getAmxAddr(amx, params[arg_types]);
+	cell *hashes = getAmxAddr(amx, params[arg_hashes]);
+
+	std::vector<std::string> filenames(params[arg_size]);
+	std::vector<CQueryFileManager::query_t> queries(params[arg_size]);
+
+	for (cell i = 0; i < params[arg_size]; i++)
+	{
+		ResourceType_e flag = (ResourceType_e)types[i];
+		switch (flag)
+		{
+		case RES_TYPE_NONE:
+		case RES_TYPE_IGNORE:
+			AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: invalid flag type \"%i\" of file %i.", __FUNCTION__, flag, i);
+			return FALSE;
+		case RES_TYPE_EXISTS:
+			if (hashes[i] == -1) {
+				flag = RES_TYPE_HASH_ANY;
+			}
+			break;
+		default:
+			break;
+		}
+
+		char filename[MAX_PATH];
+		const char *file = getAmxString((cell *)((uint8 *)&files[i] + files[i]), filename);
+		if (!file || file[0] == '\0') {
+			AMXX_LogError(amx, AMX_ERR_NATIVE, "%s: file %i can not be empty.", __FUNCTION__, i);
+			return FALSE;
+		}
+
+		filenames[i] = file;
+		queries[i].filename = filenames[i].c_str();
+		queries[i].flag = flag;
+		queries[i].hash = hashes[i];
+	}
+
+	return g_queryFileManager.AddBatch(amx, queries, func);
+}
+
 /*
 * Unregister the forward.
 * Use the return value from RegisterQueryFile as the parameter here!
@@ -71,6 +147,7 @@ cell AMX_NATIVE_CALL UnRegisterQueryFile(AMX *amx, cell *params)
 AMX_NATIVE_INFO Rechecker_Natives[] =
 {
 	{ "RegisterQueryFile",   RegisterQueryFile   },
+	{ "RegisterQueryFiles",  RegisterQueryFiles  },
 	{ "UnRegisterQueryFile", UnRegisterQueryFile },
 
 	{ nullptr, nullptr }
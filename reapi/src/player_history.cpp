@@ -0,0 +1,162 @@
+#include "precompiled.h"
+
+CPlayerHistory g_playerHistory;
+
+void CPlayerHistory::SaveState(edict_t *pEdict, record_t &state)
+{
+	entvars_t *pev = &pEdict->v;
+
+	state.time = gpGlobals->time;
+	state.origin = pev->origin;
+	state.angles = pev->angles;
+	state.mins = pev->mins;
+	state.maxs = pev->maxs;
+	state.flags = pev->flags;
+	state.sequence = pev->sequence;
+	state.frame = pev->frame;
+	state.solid = pev->solid;
+}
+
+void CPlayerHistory::LoadState(edict_t *pEdict, const record_t &state)
+{
+	entvars_t *pev = &pEdict->v;
+
+	pev->angles = state.angles;
+	pev->sequence = state.sequence;
+	pev->frame = state.frame;
+
+	// relink with the historical hull
+	SET_SIZE(pEdict, state.mins, state.maxs);
+	SET_ORIGIN(pEdict, state.origin);
+}
+
+void CPlayerHistory::Record()
+{
+	if (!g_pEdicts)
+		return;
+
+	for (int index = 1; index <= gpGlobals->maxClients; index++)
+	{
+		edict_t *pEdict = edictByIndex(index);
+		if (pEdict->free || !(pEdict->v.flags & FL_CLIENT))
+			continue;
+
+		auto &player = m_players[index - 1];
+
+		// the server is paused, or the frames are too frequent to keep HISTORY_TIME in the records
+		if (player.count)
+		{
+			float elapsed = gpGlobals->time - GetRecord(player, 0).time;
+			if (elapsed >= 0 && elapsed < HISTORY_INTERVAL)
+				continue;
+		}
+
+		SaveState(pEdict, player.records[player.head]);
+		player.head = (player.head + 1) % MAX_HISTORY_RECORDS;
+
+		if (player.count < MAX_HISTORY_RECORDS)
+			player.count++;
+	}
+}
+
+void CPlayerHistory::ResetPlayer(size_t index)
+{
+	m_players[index - 1].head = 0;
+	m_players[index - 1].count = 0;
+}
+
+void CPlayerHistory::Clear()
+{
+	for (size_t index = 1; index <= MAX_CLIENTS; index++)
+		ResetPlayer(index);
+
+	m_rewound = 0;
+}
+
+static float LerpAngle(float from, float to, float frac)
+{
+	float delta = to - from;
+
+	if (delta > 180)
+		delta -= 360;
+	else if (delta < -180)
+		delta += 360;
+
+	return from + delta * frac;
+}
+
+bool CPlayerHistory::GetState(size_t index, float time, record_t &state) const
+{
+	auto &player = m_players[index - 1];
+	if (!player.count)
+		return false;
+
+	// newer than the last frame, nothing to rewind
+	if (time >= GetRecord(player, 0).time) {
+		state = GetRecord(player, 0);
+		return true;
+	}
+
+	for (size_t age = 1; age < player.count; age++)
+	{
+		auto &older = GetRecord(player, age);
+		if (older.time > time)
+			continue;
+
+		auto &newer = GetRecord(player, age - 1);
+		float frac = (time - older.time) / (newer.time - older.time);
+
+		// the discrete state is taken from the nearest frame
+		state = (frac < 0.5f) ? older : newer;
+		state.time = time;
+
+		// don't interpolate through the death or respawn
+		if (older.solid != newer.solid)
+			return true;
+
+		state.origin = older.origin + (newer.origin - older.origin) * frac;
+		state.mins = older.mins + (newer.mins - older.mins) * frac;
+		state.maxs = older.maxs + (newer.maxs - older.maxs) * frac;
+
+		for (int i = 0; i < 3; i++)
+			state.angles[i] = LerpAngle(older.angles[i], newer.angles[i], frac);
+
+		if (older.sequence == newer.sequence)
+			state.frame = older.frame + (newer.frame - older.frame) * frac;
+
+		return true;
+	}
+
+	// older than the history
+	return false;
+}
+
+void CPlayerHistory::Rewind(float time, edict_t *pSkip)
+{
+	m_rewound = 0;
+
+	for (int index = 1; index <= gpGlobals->maxClients; index++)
+	{
+		edict_t *pEdict = edictByIndex(index);
+		if (pEdict == pSkip || pEdict->free || !(pEdict->v.flags & FL_CLIENT))
+			continue;
+
+		record_t state;
+		if (!GetState(index, time, state) || state.solid == SOLID_NOT)
+			continue;
+
+		SaveState(pEdict, m_saved[index - 1]);
+		LoadState(pEdict, state);
+
+		m_rewound |= 1u << (index - 1);
+	}
+}
+
+void CPlayerHistory::Restore()
+{
+	for (int index = 1; m_rewound; index++, m_rewound >>= 1)
+	{
+		if (m_rewound & 1)
+			LoadState(edictByIndex(index), m_saved[index - 1]);
+	}
+}
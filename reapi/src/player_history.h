@@ -0,0 +1,61 @@
+#pragma once
+
+#define HISTORY_TIME        1.0f   // seconds of the history kept at any frame rate
+#define MAX_HISTORY_RECORDS 1024   // a record per frame up to 1000 fps
+
+// frames closer than that to the last record aren't recorded
+#define HISTORY_INTERVAL    (HISTORY_TIME / (MAX_HISTORY_RECORDS - 1))
+
+// History of the player positions, recorded once per server frame.
+// Used for lag-compensated checks without copying the state into AMX.
+class CPlayerHistory
+{
+public:
+	// layout matches PlayerHistory enum of the plugins
+	struct record_t
+	{
+		float time;
+		Vector origin;
+		Vector angles;
+		Vector mins;
+		Vector maxs;
+		int flags;
+		int sequence;
+		float frame;
+		int solid;
+	};
+
+	void Record();
+	void ResetPlayer(size_t index);
+	void Clear();
+
+	// state of the player at the given time, interpolated between the frames
+	bool GetState(size_t index, float time, record_t &state) const;
+
+	// move players back to the given time for the trace and return them
+	void Rewind(float time, edict_t *pSkip);
+	void Restore();
+
+private:
+	struct player_t
+	{
+		record_t records[MAX_HISTORY_RECORDS];
+		size_t head;    // next record to write
+		size_t count;
+	};
+
+	const record_t &GetRecord(const player_t &player, size_t age) const
+	{
+		return player.records[(player.head + MAX_HISTORY_RECORDS - 1 - age) % MAX_HISTORY_RECORDS];
+	}
+
+	static void SaveState(edict_t *pEdict, record_t &state);
+	static void LoadState(edict_t *pEdict, const record_t &state);
+
+	player_t m_players[MAX_CLIENTS] = {};
+
+	record_t m_saved[MAX_CLIENTS];  // current state of the rewound players
+	uint32 m_rewound = 0;
+};
+
+extern CPlayerHistory g_playerHistory;
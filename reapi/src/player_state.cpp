@@ -0,0 +1,74 @@
+#include "precompiled.h"
+
+CPlayerStates g_playerStates;
+
+void CPlayerStates::Bind(AMX *amx, cell address)
+{
+	// one array per plugin
+	for (auto &binding : m_bindings)
+	{
+		if (binding.amx == amx) {
+			binding.address = address;
+			return;
+		}
+	}
+
+	m_bindings.push_back({ amx, address });
+}
+
+bool CPlayerStates::Unbind(AMX *amx)
+{
+	for (auto iter = m_bindings.begin(); iter != m_bindings.end(); iter++)
+	{
+		if (iter->amx == amx) {
+			m_bindings.erase(iter);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void CPlayerStates::Clear()
+{
+	m_bindings.clear();
+}
+
+void CPlayerStates::Update()
+{
+	if (m_bindings.empty())
+		return;
+
+	Q_memset(m_states, 0, sizeof(m_states));
+
+	for (int index = 1; index <= gpGlobals->maxClients; index++)
+	{
+		CBasePlayer *pPlayer = UTIL_PlayerByIndex(index);
+		if (!pPlayer || pPlayer->has_disconnected)
+			continue;
+
+		auto &state = m_states[index];
+
+		state.alive = pPlayer->IsAlive() ? TRUE : FALSE;
+		state.team = pPlayer->m_iTeam;
+		state.health = pPlayer->pev->health;
+		state.armor = pPlayer->pev->armorvalue;
+		state.origin = pPlayer->pev->origin;
+		state.velocity = pPlayer->pev->velocity;
+		state.flags = pPlayer->pev->flags;
+		state.weapon = pPlayer->m_pActiveItem ? pPlayer->m_pActiveItem->m_iId : WEAPON_NONE;
+		state.money = pPlayer->m_iAccount;
+	}
+
+	for (auto &binding : m_bindings)
+	{
+		cell *table = getAmxAddr(binding.amx, binding.address);
+
+		// the rows are reached through the indirection vector of the array
+		for (int index = 0; index <= gpGlobals->maxClients; index++)
+		{
+			cell *row = (cell *)((uint8 *)&table[index] + table[index]);
+			Q_memcpy(row, &m_states[index], sizeof(state_t));
+		}
+	}
+}
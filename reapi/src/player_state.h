@@ -0,0 +1,38 @@
+#pragma once
+
+// Shared table of the player states, refreshed once per server frame
+// into the plugin arrays bound with rg_bind_player_state.
+class CPlayerStates
+{
+public:
+	// layout matches PlayerState enum of the plugins
+	struct state_t
+	{
+		cell alive;
+		cell team;
+		float health;
+		float armor;
+		Vector origin;
+		Vector velocity;
+		cell flags;
+		cell weapon;
+		cell money;
+	};
+
+	void Bind(AMX *amx, cell address);
+	bool Unbind(AMX *amx);
+	void Update();
+	void Clear();
+
+private:
+	struct binding_t
+	{
+		AMX *amx;
+		cell address;   // array[MAX_PLAYERS + 1][PlayerState]
+	};
+
+	std::vector<binding_t> m_bindings;
+	state_t m_states[MAX_CLIENTS + 1];
+};
+
+extern CPlayerStates g_playerStates;
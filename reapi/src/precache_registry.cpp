@@ -0,0 +1,215 @@
+#include "precompiled.h"
+
+CPrecacheRegistry g_precacheRegistry;
+
+uint32 CPathTable::Hash(const char *path)
+{
+	// FNV-1a of the lower case path
+	uint32 hash = 2166136261u;
+	for (; *path; path++)
+	{
+		hash ^= (uint8)tolower((unsigned char)*path);
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+size_t CPathTable::Lookup(const char *path, uint32 hash) const
+{
+	size_t mask = m_slots.size() - 1;
+	size_t i = hash & mask;
+
+	// linear probing up to the path or a free slot
+	while (!m_slots[i].path.empty())
+	{
+		if (m_slots[i].hash == hash && !Q_stricmp(m_slots[i].path.c_str(), path))
+			break;
+
+		i = (i + 1) & mask;
+	}
+
+	return i;
+}
+
+int CPathTable::Find(const char *path) const
+{
+	if (!m_count || !*path)
+		return -1;
+
+	auto &slot = m_slots[Lookup(path, Hash(path))];
+	return slot.path.empty() ? -1 : slot.value;
+}
+
+void CPathTable::Set(const char *path, int value)
+{
+	if (!*path)
+		return;
+
+	// keep the load under 3/4
+	if ((m_count + 1) * 4 > m_slots.size() * 3)
+		Grow();
+
+	uint32 hash = Hash(path);
+	auto &slot = m_slots[Lookup(path, hash)];
+
+	if (slot.path.empty())
+	{
+		slot.hash = hash;
+		slot.path = path;
+		m_count++;
+	}
+
+	slot.value = value;
+}
+
+void CPathTable::Grow()
+{
+	std::vector<slot_t> slots(m_slots.empty() ? 256 : m_slots.size() * 2);
+	m_slots.swap(slots);
+
+	for (auto &slot : slots)
+	{
+		if (slot.path.empty())
+			continue;
+
+		auto &dest = m_slots[Lookup(slot.path.c_str(), slot.hash)];
+		dest.hash = slot.hash;
+		dest.value = slot.value;
+		dest.path = std::move(slot.path);
+	}
+}
+
+void CPathTable::Clear()
+{
+	m_slots.clear();
+	m_count = 0;
+}
+
+void CPrecacheRegistry::Init()
+{
+	// the resources are recorded from the load of module
+	if (m_initialized || !api_cfg.hasReHLDS())
+		return;
+
+	m_hooks[PT_MODEL] = g_hookManager.getHook(RH_PF_precache_model_I);
+	m_hooks[PT_SOUND] = g_hookManager.getHook(RH_PF_precache_sound_I);
+	m_hooks[PT_GENERIC] = g_hookManager.getHook(RH_PF_precache_generic_I);
+
+	for (auto hook : m_hooks)
+		hook->acquire();
+
+	m_initialized = true;
+}
+
+void CPrecacheRegistry::Shutdown()
+{
+	if (m_initialized)
+	{
+		for (auto hook : m_hooks)
+			hook->release();
+
+		m_initialized = false;
+	}
+
+	Clear();
+	ClearRules();
+}
+
+void CPrecacheRegistry::Clear()
+{
+	for (auto &table : m_precached)
+		table.Clear();
+
+	// the strings of engine are freed with the map
+	for (auto &replacement : m_replacements)
+		replacement.allocated = iStringNull;
+}
+
+void CPrecacheRegistry::AddRule(const char *path, const char *replacement)
+{
+	int rule = m_rules.Find(path);
+	if (rule != -1) {
+		m_replacements[rule] = { replacement, iStringNull };
+		return;
+	}
+
+	m_rules.Set(path, m_replacements.size());
+	m_replacements.push_back({ replacement, iStringNull });
+}
+
+const char *CPrecacheRegistry::Allocate(replacement_t &replacement)
+{
+	// the engine keeps the pointer, the string has to live until the map change
+	if (replacement.allocated == iStringNull)
+		replacement.allocated = ALLOC_STRING(replacement.path.c_str());
+
+	return STRING(replacement.allocated);
+}
+
+const char *CPrecacheRegistry::Resolve(PrecacheType type, const char *path)
+{
+	int rule = m_rules.Find(path);
+	if (rule == -1)
+		return nullptr;
+
+	auto &replacement = m_replacements[rule];
+	if (replacement.path.empty())
+		return "";
+
+	// the rule is added after the precache of the original path
+	if (m_precached[type].Find(replacement.path.c_str()) == -1)
+		return nullptr;
+
+	return Allocate(replacement);
+}
+
+int CPrecacheRegistry::LoadRules(const char *filename)
+{
+	FILE *fp = fopen(filename, "rt");
+	if (!fp)
+		return -1;
+
+	char line[512];
+	int count = 0;
+
+	while (fgets(line, sizeof(line), fp))
+	{
+		char *path = line;
+		while (isspace((unsigned char)*path))
+			path++;
+
+		// empty line or comment
+		if (!*path || *path == ';' || *path == '#' || (path[0] == '/' && path[1] == '/'))
+			continue;
+
+		char *end = path;
+		while (*end && !isspace((unsigned char)*end))
+			end++;
+
+		char *replacement = end;
+		while (isspace((unsigned char)*replacement))
+			replacement++;
+
+		*end = '\0';
+
+		// no replacement blocks the path
+		end = replacement;
+		while (*end && !isspace((unsigned char)*end))
+			end++;
+
+		*end = '\0';
+
+		AddRule(path, replacement);
+		count++;
+	}
+
+	fclose(fp);
+	return count;
+}
+
+void CPrecacheRegistry::ClearRules()
+{
+	m_rules.Clear();
+	m_replacements.clear();
+}
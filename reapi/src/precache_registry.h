@@ -0,0 +1,111 @@
+#pragma once
+
+enum PrecacheType
+{
+	PT_MODEL,
+	PT_SOUND,
+	PT_GENERIC,
+	PT_MAX
+};
+
+// Open addressing hash table of the paths, case insensitive like the precache of engine
+class CPathTable
+{
+public:
+	int Find(const char *path) const;   // -1 if not found
+	void Set(const char *path, int value);
+	void Clear();
+	size_t Count() const { return m_count; }
+
+private:
+	struct slot_t
+	{
+		uint32 hash;
+		int value;
+		std::string path;   // empty for the free slot
+	};
+
+	static uint32 Hash(const char *path);
+	size_t Lookup(const char *path, uint32 hash) const;
+	void Grow();
+
+	std::vector<slot_t> m_slots;
+	size_t m_count = 0;
+};
+
+// Precached resources of the map and the replacement rules applied inside the precache hooks.
+// The repeated precache of the same path returns the known index without going through
+// the hookchain while no plugin hooks it. The game uses the resources by the original path,
+// so the same rules are applied in the engine hooks of SET_MODEL, MODEL_INDEX and EMIT_SOUND.
+class CPrecacheRegistry
+{
+public:
+	void Init();
+	void Shutdown();
+	void Clear();   // on map change, the rules are kept
+
+	void AddRule(const char *path, const char *replacement);
+	int LoadRules(const char *filename);
+	void ClearRules();
+
+	int GetIndex(PrecacheType type, const char *path) const { return m_precached[type].Find(path); }
+	bool HasRules() const { return m_initialized && m_rules.Count() != 0; }
+
+	// path used instead of the original one, nullptr if there is no rule
+	// or the replacement isn't precached, empty string if blocked
+	const char *Resolve(PrecacheType type, const char *path);
+
+	// called by the hook wrappers
+	template <typename original_t>
+	int Precache(PrecacheType type, const char *path, original_t original);
+
+private:
+	CPathTable m_precached[PT_MAX];
+	hook_t *m_hooks[PT_MAX] = {};
+	struct replacement_t
+	{
+		std::string path;    // empty if blocked
+		string_t allocated;  // path in the string base of engine, until the map change
+	};
+
+	const char *Allocate(replacement_t &replacement);
+
+	CPathTable m_rules;                     // index of the replacement
+	std::vector<replacement_t> m_replacements;
+	bool m_initialized = false;
+};
+
+extern CPrecacheRegistry g_precacheRegistry;
+
+template <typename original_t>
+int CPrecacheRegistry::Precache(PrecacheType type, const char *path, original_t original)
+{
+	// the plugins see each call of the hookchain
+	const hook_t *hook = m_hooks[type];
+	if (hook->pre.empty() && hook->post.empty())
+	{
+		int index = m_precached[type].Find(path);
+		if (index != -1)
+			return index;
+	}
+
+	const char *resolved = path;
+
+	int rule = m_rules.Find(path);
+	if (rule != -1)
+	{
+		// blocked
+		if (m_replacements[rule].path.empty())
+			return 0;
+
+		resolved = Allocate(m_replacements[rule]);
+	}
+
+	int index = original((char *)resolved);
+
+	m_precached[type].Set(path, index);
+	if (resolved != path)
+		m_precached[type].Set(resolved, index);
+
+	return index;
+}
@@ -10,6 +10,12 @@
 // C++
 #include <vector>				// std::vector
 #include <list>					// std::list
+#include <string>				// std::string
+#include <deque>				// std::deque
+#include <mutex>				// std::mutex
+#include <condition_variable>	// std::condition_variable
+#include <atomic>				// std::atomic
+#include <unordered_map>		// std::unordered_map
 
 // platform defs
 #include "platform.h"
@@ -58,11 +64,30 @@
 
 // reapi main
 #include "main.h"
+#include "sys_clock.h"
+#include "sys_thread.h"
 #include "api_config.h"
 #include "hook_manager.h"
+#include "metrics.h"
 #include "hook_callback.h"
+#include "think_batch.h"
+#include "move_modifiers.h"
+#include "voice_matrix.h"
+#include "player_history.h"
+#include "entity_snapshot.h"
+#include "player_state.h"
+#include "radius_damage.h"
+#include "job_scheduler.h"
+#include "worker_pool.h"
+#include "worker_tasks.h"
+#include "log_tap.h"
+#include "precache_registry.h"
+#include "entity_init_cache.h"
 #include "entity_callback_dispatcher.h"
 #include "member_list.h"
+#include "entity_templates.h"
+#include "entity_pool.h"
+#include "bone_cache.h"
 
 // natives
 #include "natives_hookchains.h"
@@ -70,6 +95,7 @@
 #include "natives_misc.h"
 #include "natives_nav.h"
 #include "natives_common.h"
+#include "natives_async.h"
 #include "natives_helper.h"
 
 // addons
@@ -0,0 +1,257 @@
+#include "precompiled.h"
+
+CDamageGrid g_damageGrid;
+
+// the same test as UTIL_FindEntityInSphere, distance from the point to the bounding box
+inline bool BoxInSphere(const edict_t *pEdict, const Vector &vecSrc, float flRadius)
+{
+	float distSquared = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		float delta = 0;
+		if (vecSrc[i] < pEdict->v.absmin[i])
+			delta = vecSrc[i] - pEdict->v.absmin[i];
+		else if (vecSrc[i] > pEdict->v.absmax[i])
+			delta = vecSrc[i] - pEdict->v.absmax[i];
+
+		distSquared += delta * delta;
+	}
+
+	return distSquared <= flRadius * flRadius;
+}
+
+void CDamageGrid::Link(edict_t *pEdict)
+{
+	entry_t &entry = m_entries[indexOfEdict(pEdict)];
+
+	int minX = CellCoord(pEdict->v.absmin.x), maxX = CellCoord(pEdict->v.absmax.x);
+	int minY = CellCoord(pEdict->v.absmin.y), maxY = CellCoord(pEdict->v.absmax.y);
+
+	// still in the same cells, the most of entities between the frames
+	if (entry.linked && entry.minX == minX && entry.minY == minY && entry.maxX == maxX && entry.maxY == maxY)
+		return;
+
+	Unlink(pEdict);
+
+	entry = { minX, minY, maxX, maxY, true };
+
+	if (IsLarge(entry)) {
+		m_large.push_back(pEdict);
+		return;
+	}
+
+	// the entity is put to each cell its bounding box covers
+	for (int x = minX; x <= maxX; x++)
+	{
+		for (int y = minY; y <= maxY; y++)
+			m_cells[CellKey(x, y)].push_back(pEdict);
+	}
+}
+
+void CDamageGrid::Unlink(edict_t *pEdict)
+{
+	entry_t &entry = m_entries[indexOfEdict(pEdict)];
+	if (!entry.linked)
+		return;
+
+	auto remove = [pEdict](std::vector<edict_t *> &list) {
+		auto iter = std::find(list.begin(), list.end(), pEdict);
+		if (iter != list.end()) {
+			*iter = list.back();
+			list.pop_back();
+		}
+	};
+
+	if (IsLarge(entry)) {
+		remove(m_large);
+	}
+	else
+	{
+		for (int x = entry.minX; x <= entry.maxX; x++)
+		{
+			for (int y = entry.minY; y <= entry.maxY; y++)
+				remove(m_cells[CellKey(x, y)]);
+		}
+	}
+
+	entry.linked = false;
+}
+
+void CDamageGrid::Sync()
+{
+	if (m_entries.size() != size_t(gpGlobals->maxEntities))
+		m_entries.assign(gpGlobals->maxEntities, entry_t {});
+
+	for (int index = 1; index < gpGlobals->maxEntities; index++)
+	{
+		// takedamage is checked by the query, it could be set later in the frame
+		edict_t *pEdict = edictByIndex(index);
+		if (pEdict->free || !pEdict->pvPrivateData)
+			Unlink(pEdict);
+		else
+			Link(pEdict);
+	}
+
+	m_synced = true;
+}
+
+void CDamageGrid::Move(edict_t *pEdict)
+{
+	// the teleported or spawned entity in the middle of frame
+	if (!m_synced || pEdict->free || !pEdict->pvPrivateData)
+		return;
+
+	if (indexOfEdict(pEdict) > 0)
+		Link(pEdict);
+}
+
+void CDamageGrid::Clear()
+{
+	m_entries.clear();
+	m_cells.clear();
+	m_large.clear();
+	m_synced = false;
+}
+
+void CDamageGrid::Query(const Vector &center, float radius, std::vector<edict_t *> &result)
+{
+	if (!m_synced)
+		Sync();
+
+	float range = radius + MOVE_MARGIN;
+
+	int minX = CellCoord(center.x - range), maxX = CellCoord(center.x + range);
+	int minY = CellCoord(center.y - range), maxY = CellCoord(center.y + range);
+
+	for (int x = minX; x <= maxX; x++)
+	{
+		for (int y = minY; y <= maxY; y++)
+		{
+			auto cell = m_cells.find(CellKey(x, y));
+			if (cell != m_cells.end())
+				result.insert(result.end(), cell->second.begin(), cell->second.end());
+		}
+	}
+
+	result.insert(result.end(), m_large.begin(), m_large.end());
+
+	// an entity can be in a few cells, the edicts are sorted by index
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+int RadiusDamageEx(Vector vecSrc, entvars_t *pevInflictor, entvars_t *pevAttacker, float flDamage, float flRadius, int iClassIgnore, int bitsDamageType, const radiusdamage_t &options)
+{
+	float falloff = flRadius ? flDamage / flRadius : 1.0f;
+	bool bInWater = POINT_CONTENTS(vecSrc) == CONTENTS_WATER;
+
+	// in case grenade is lying on the ground
+	vecSrc.z += 1;
+
+	if (!pevAttacker)
+		pevAttacker = pevInflictor;
+
+	struct candidate_t
+	{
+		CBaseEntity *pEntity;
+		float distance;
+	};
+
+	// not static, the damage could cause another explosion
+	std::vector<edict_t *> nearby;
+	std::vector<candidate_t> candidates;
+
+	g_damageGrid.Query(vecSrc, flRadius, nearby);
+
+	// cull in C++ before any trace
+	for (auto pEdict : nearby)
+	{
+		if (pEdict->free || pEdict->v.takedamage == DAMAGE_NO)
+			continue;
+
+		if (!BoxInSphere(pEdict, vecSrc, flRadius))
+			continue;
+
+		// blast's don't travel into or out of water
+		if (bInWater ? pEdict->v.waterlevel == 0 : pEdict->v.waterlevel == 3)
+			continue;
+
+		if (options.ignoreClass && FClassnameIs(pEdict, options.ignoreClass))
+			continue;
+
+		CBaseEntity *pEntity = getPrivate<CBaseEntity>(pEdict);
+		if (!pEntity)
+			continue;
+
+		if (iClassIgnore != CLASS_NONE && pEntity->Classify() == iClassIgnore)
+			continue;
+
+		if (options.ignoreTeam != UNASSIGNED && pEntity->IsPlayer() && static_cast<CBasePlayer *>(pEntity)->m_iTeam == options.ignoreTeam)
+			continue;
+
+		// the falloff is measured to the origin as the game does, to the center for func_breakable
+		Vector vecTarget = FClassnameIs(pEdict, "func_breakable") ? pEntity->Center() : pEdict->v.origin;
+		candidates.push_back({ pEntity, (vecSrc - vecTarget).Length() });
+	}
+
+	bool traced = (options.flags & (RDF_LINE_OF_SIGHT | RDF_TRACE_ATTACK)) != 0;
+	if (traced)
+	{
+		// the nearest ones get the traces first
+		std::stable_sort(candidates.begin(), candidates.end(), [](const candidate_t &a, const candidate_t &b) { return a.distance < b.distance; });
+
+		if (options.maxTraces && candidates.size() > options.maxTraces)
+			candidates.resize(options.maxTraces);
+	}
+
+	int damaged = 0;
+	edict_t *pentInflictor = pevInflictor ? pevInflictor->pContainingEntity : nullptr;
+
+	for (auto &candidate : candidates)
+	{
+		CBaseEntity *pEntity = candidate.pEntity;
+
+		// could be killed by the previous damage
+		if (pEntity->pev->takedamage == DAMAGE_NO)
+			continue;
+
+		float flAdjustedDamage = flDamage - candidate.distance * falloff;
+		if (flAdjustedDamage < 0)
+			flAdjustedDamage = 0;
+
+		if (!traced)
+		{
+			pEntity->TakeDamage(pevInflictor, pevAttacker, flAdjustedDamage, bitsDamageType);
+			damaged++;
+			continue;
+		}
+
+		TraceResult tr;
+		Vector vecSpot = pEntity->BodyTarget(vecSrc);
+		TRACE_LINE(vecSrc, vecSpot, dont_ignore_monsters, pentInflictor, &tr);
+
+		bool hit = tr.pHit == pEntity->edict();
+		if ((options.flags & RDF_LINE_OF_SIGHT) && tr.flFraction != 1.0f && !hit)
+			continue;
+
+		if ((options.flags & RDF_TRACE_ATTACK) && hit)
+		{
+			if (tr.fStartSolid) {
+				tr.vecEndPos = vecSrc;
+				tr.flFraction = 0;
+			}
+
+			g_ReGameFuncs->ClearMultiDamage();
+			pEntity->TraceAttack(pevInflictor, flAdjustedDamage, (tr.vecEndPos - vecSrc).Normalize(), &tr, bitsDamageType);
+			g_ReGameFuncs->ApplyMultiDamage(pevInflictor, pevAttacker);
+		}
+		else
+		{
+			pEntity->TakeDamage(pevInflictor, pevAttacker, flAdjustedDamage, bitsDamageType);
+		}
+
+		damaged++;
+	}
+
+	return damaged;
+}
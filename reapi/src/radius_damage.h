@@ -0,0 +1,57 @@
+#pragma once
+
+// Grid of the entities by their bounding box, kept between the queries.
+// Each entity is moved to other cells only when its bounding box leaves its cells:
+// checked for all entities at the first query of a frame and by SET_ORIGIN.
+// Lets the radius damage look up the nearby entities instead of walking all edicts.
+class CDamageGrid
+{
+public:
+	void Frame() { m_synced = false; }
+	void Move(edict_t *pEdict);
+	void Clear();
+	void Query(const Vector &center, float radius, std::vector<edict_t *> &result);
+
+private:
+	static const int CELL_SIZE = 256;
+	static const int MOVE_MARGIN = 64;  // entities moved by the physics since the frame start
+	static const int MAX_CELLS = 64;    // bigger entities are checked by each query
+
+	static uint32 CellKey(int x, int y) { return (uint32(x & 0xFFFF) << 16) | uint32(y & 0xFFFF); }
+	static int CellCoord(float value) { return int(floor(value / CELL_SIZE)); }
+
+	struct entry_t
+	{
+		int minX, minY, maxX, maxY;     // cells of the entity
+		bool linked;
+	};
+
+	void Sync();
+	void Link(edict_t *pEdict);
+	void Unlink(edict_t *pEdict);
+	bool IsLarge(const entry_t &entry) const { return (entry.maxX - entry.minX + 1) * (entry.maxY - entry.minY + 1) > MAX_CELLS; }
+
+	std::vector<entry_t> m_entries;     // by the edict index
+	std::unordered_map<uint32, std::vector<edict_t *>> m_cells;
+	std::vector<edict_t *> m_large;     // entities covering too many cells
+	bool m_synced = false;
+};
+
+extern CDamageGrid g_damageGrid;
+
+enum RadiusDamageFlags
+{
+	RDF_NONE           = 0,
+	RDF_LINE_OF_SIGHT  = BIT(0),    // entities behind the walls don't take damage
+	RDF_TRACE_ATTACK   = BIT(1),    // damage goes through TraceAttack, the hitgroup multipliers apply
+};
+
+struct radiusdamage_t
+{
+	TeamName ignoreTeam;        // players of the team don't take damage
+	const char *ignoreClass;    // entities of the classname don't take damage
+	size_t maxTraces;           // visibility traces per explosion, 0 is unlimited
+	int flags;                  // RadiusDamageFlags
+};
+
+int RadiusDamageEx(Vector vecSrc, entvars_t *pevInflictor, entvars_t *pevAttacker, float flDamage, float flRadius, int iClassIgnore, int bitsDamageType, const radiusdamage_t &options);
@@ -45,23 +45,59 @@ ModelName GetModelAuto(TeamName team)
 
 CTempStrings::CTempStrings()
 {
-	m_current = 0;
+	m_chunks.push_back(new char[CHUNK_SIZE]);
+	m_chunk = 0;
+	m_offset = 0;
+	m_depth = 0;
+	m_peakDepth = 0;
+	m_peakBytes = 0;
 }
 
+CTempStrings::~CTempStrings()
+{
+	for (auto chunk : m_chunks)
+		delete [] chunk;
+
+	m_chunks.clear();
+}
 
-char* CTempStrings::push(AMX* amx)
+CTempStrings::mark_t CTempStrings::mark()
 {
-	if (m_current == STRINGS_MAX) {
-		AMXX_LogError(amx, AMX_ERR_NATIVE, "temp strings limit exceeded, contact reapi authors");
-		return nullptr;
-	}
+	if (++m_depth > m_peakDepth)
+		m_peakDepth = m_depth;
 
-	return m_strings[m_current++];
+	return { m_chunk, m_offset };
 }
 
-void CTempStrings::pop(size_t count)
+void CTempStrings::release(const mark_t &m)
 {
-	m_current -= count;
+	m_chunk = m.chunk;
+	m_offset = m.offset;
+	m_depth--;
+}
+
+char* CTempStrings::push(size_t size)
+{
+	if (size > STRING_SIZE)
+		size = STRING_SIZE;
+
+	if (m_offset + size > CHUNK_SIZE)
+	{
+		// the rest of current chunk is wasted until release
+		if (++m_chunk == m_chunks.size())
+			m_chunks.push_back(new char[CHUNK_SIZE]);
+
+		m_offset = 0;
+	}
+
+	char *ptr = m_chunks[m_chunk] + m_offset;
+	m_offset += size;
+
+	size_t bytes = m_chunk * CHUNK_SIZE + m_offset;
+	if (bytes > m_peakBytes)
+		m_peakBytes = bytes;
+
+	return ptr;
 }
 
 CBaseEntity *GiveNamedItemInternal(AMX *amx, CBasePlayer *pPlayer, const char *pszItemName, const size_t uid)
@@ -171,9 +207,26 @@ void GetBonePosition(CBaseEntity *pEntity, int iBone, Vector *pVecOrigin, Vector
 	// force to update frame
 	StudioFrameAdvanceEnt(pstudiohdr, pEdict);
 
-	pEntity->pev->angles.x = -pEntity->pev->angles.x;
-	GET_BONE_POSITION(pEdict, iBone, vecOrigin, vecAngles);
-	pEntity->pev->angles.x = -pEntity->pev->angles.x;
+	// the whole skeleton is set up once for the queries of the frame
+	auto transforms = g_boneCache.GetSkeleton(pEdict, pstudiohdr);
+	if (transforms)
+	{
+		vecOrigin = Vector(transforms[iBone].m[0][3], transforms[iBone].m[1][3], transforms[iBone].m[2][3]);
+	}
+	else
+	{
+		auto cached = g_boneCache.GetBone(pEdict, pstudiohdr, iBone);
+		if (!cached->valid)
+		{
+			pEntity->pev->angles.x = -pEntity->pev->angles.x;
+			GET_BONE_POSITION(pEdict, iBone, cached->origin, cached->angles);
+			pEntity->pev->angles.x = -pEntity->pev->angles.x;
+			cached->valid = true;
+		}
+
+		vecOrigin = cached->origin;
+		vecAngles = cached->angles;
+	}
 
 	// ReGameDLL already have fixes angles for non-players entities
 	if (!g_ReGameApi && !pEntity->IsPlayer()) {
@@ -189,6 +242,41 @@ void GetBonePosition(CBaseEntity *pEntity, int iBone, Vector *pVecOrigin, Vector
 	}
 }
 
+void GetBonePositions(CBaseEntity *pEntity, const cell *pBones, cell *pOrigins, size_t count)
+{
+	edict_t *pEdict = pEntity->edict();
+	const CBoneCache::bonematrix_t *transforms = nullptr;
+
+	studiohdr_t *pstudiohdr = static_cast<studiohdr_t *>(GET_MODEL_PTR(pEdict));
+	if (pstudiohdr)
+	{
+		// force to update frame
+		StudioFrameAdvanceEnt(pstudiohdr, pEdict);
+
+		// all bones are read from the skeleton set up once
+		transforms = g_boneCache.GetSkeleton(pEdict, pstudiohdr);
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		// the rows of the two-dimensional array of plugin
+		Vector *pVecOrigin = (Vector *)((uint8 *)&pOrigins[i] + pOrigins[i]);
+		int iBone = pBones[i];
+
+		if (!transforms || iBone < 0 || iBone >= pstudiohdr->numbones) {
+			GetBonePosition(pEntity, iBone, pVecOrigin, nullptr);
+			continue;
+		}
+
+		*pVecOrigin = Vector(transforms[iBone].m[0][3], transforms[iBone].m[1][3], transforms[iBone].m[2][3]);
+
+		// ReGameDLL already have fixes angles for non-players entities
+		if (!g_ReGameApi && !pEntity->IsPlayer()) {
+			FixupAngles(pEdict, *pVecOrigin);
+		}
+	}
+}
+
 void GetAttachment(CBaseEntity *pEntity, int iAttachment, Vector *pVecOrigin, Vector *pVecAngles)
 {
 	Vector vecOrigin, vecAngles;
@@ -207,7 +295,28 @@ void GetAttachment(CBaseEntity *pEntity, int iAttachment, Vector *pVecOrigin, Ve
 	// force to update frame
 	StudioFrameAdvanceEnt(pstudiohdr, pEdict);
 
-	GET_ATTACHMENT(pEdict, iAttachment, vecOrigin, vecAngles);
+	auto transforms = g_boneCache.GetSkeleton(pEdict, pstudiohdr);
+	if (transforms)
+	{
+		// the attachment point in the space of its bone
+		mstudioattachment_t *pattachment = (mstudioattachment_t *)((byte *)pstudiohdr + pstudiohdr->attachmentindex) + iAttachment;
+		const auto &transform = transforms[pattachment->bone].m;
+
+		for (int i = 0; i < 3; i++)
+			vecOrigin[i] = DotProduct(pattachment->org, transform[i]) + transform[i][3];
+	}
+	else
+	{
+		auto cached = g_boneCache.GetAttachment(pEdict, pstudiohdr, iAttachment);
+		if (!cached->valid)
+		{
+			GET_ATTACHMENT(pEdict, iAttachment, cached->origin, cached->angles);
+			cached->valid = true;
+		}
+
+		vecOrigin = cached->origin;
+		vecAngles = cached->angles;
+	}
 
 	// ReGameDLL already have fixes angles for non-players entities
 	if (!g_ReGameApi && !pEntity->IsPlayer()) {
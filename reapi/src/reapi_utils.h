@@ -54,6 +54,7 @@ void UTIL_ServerPrint(const char *fmt, ...);
 CBaseEntity *GiveNamedItemInternal(AMX *amx, CBasePlayer *pPlayer, const char *pszItemName, const size_t uid = 0);
 
 void GetBonePosition(CBaseEntity *pEntity, int iBone, Vector *pVecOrigin, Vector *pVecAngles);
+void GetBonePositions(CBaseEntity *pEntity, const cell *pBones, cell *pOrigins, size_t count);
 void GetAttachment(CBaseEntity *pEntity, int iAttachment, Vector *pVecOrigin, Vector *pVecAngles);
 void SetBodygroup(CBaseEntity *pEntity, int iGroup, int iValue);
 int GetBodygroup(CBaseEntity *pEntity, int iGroup);
@@ -0,0 +1,25 @@
+#include "precompiled.h"
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+uint64 Sys_NanoTime()
+{
+#ifdef _WIN32
+	static LARGE_INTEGER frequency = {};
+	if (!frequency.QuadPart)
+		QueryPerformanceFrequency(&frequency);
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+
+	// split to avoid the overflow of counter * 1e9
+	uint64 ticks = counter.QuadPart, freq = frequency.QuadPart;
+	return (ticks / freq) * 1000000000ull + (ticks % freq) * 1000000000ull / freq;
+#else
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return uint64(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+#endif
+}
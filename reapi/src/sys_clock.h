@@ -0,0 +1,8 @@
+#pragma once
+
+// Monotonic time in nanoseconds, the origin is arbitrary.
+// std::chrono clocks aren't used, they need a newer libstdc++ than the supported one.
+uint64 Sys_NanoTime();
+
+inline uint64 Sys_MicroTime() { return Sys_NanoTime() / 1000; }
+inline double Sys_SecondsSince(uint64 start) { return (Sys_NanoTime() - start) / 1e9; }
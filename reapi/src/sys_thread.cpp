@@ -0,0 +1,68 @@
+#include "precompiled.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+bool CThread::Start(void (*func)(void *), void *arg)
+{
+	if (m_running)
+		return false;
+
+	m_func = func;
+	m_arg = arg;
+
+#ifdef _WIN32
+	m_thread = std::thread(func, arg);
+#else
+	if (pthread_create(&m_thread, nullptr, &CThread::Routine, this) != 0)
+		return false;
+#endif
+
+	m_running = true;
+	return true;
+}
+
+void CThread::Join()
+{
+	if (!m_running)
+		return;
+
+#ifdef _WIN32
+	m_thread.join();
+#else
+	pthread_join(m_thread, nullptr);
+#endif
+
+	m_running = false;
+}
+
+#ifndef _WIN32
+void *CThread::Routine(void *thread)
+{
+	auto self = static_cast<CThread *>(thread);
+	self->m_func(self->m_arg);
+	return nullptr;
+}
+#endif
+
+size_t Sys_CpuCount()
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors;
+#else
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? size_t(count) : 0;
+#endif
+}
+
+void Sys_Sleep(int msec)
+{
+#ifdef _WIN32
+	Sleep(msec);
+#else
+	usleep(msec * 1000);
+#endif
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#ifdef _WIN32
+#include <thread>
+#else
+#include <pthread.h>
+#endif
+
+// Thread running a member function of an object.
+// On Linux it is a plain pthread, the constructor of std::thread
+// needs a newer libstdc++ than the supported one.
+class CThread
+{
+public:
+	CThread() {}
+	~CThread() { Join(); }
+
+	CThread(const CThread &) = delete;
+	CThread &operator=(const CThread &) = delete;
+
+	template <typename T, void (T::*Func)()>
+	bool Start(T *object)
+	{
+		return Start([](void *arg) { (static_cast<T *>(arg)->*Func)(); }, object);
+	}
+
+	bool Start(void (*func)(void *), void *arg);
+	void Join();
+	bool IsRunning() const { return m_running; }
+
+private:
+#ifdef _WIN32
+	std::thread m_thread;
+#else
+	static void *Routine(void *thread);
+	pthread_t m_thread;
+#endif
+
+	void (*m_func)(void *) = nullptr;
+	void *m_arg = nullptr;
+	bool m_running = false;
+};
+
+// count of the online processors, 0 if unknown
+size_t Sys_CpuCount();
+void Sys_Sleep(int msec);
@@ -0,0 +1,78 @@
+#include "precompiled.h"
+
+CThinkBatch g_thinkBatch;
+
+void CThinkBatch::Add(batch_e type, cell handle, int filter, TeamName team)
+{
+	m_handlers[type].push_back({ handle, filter, team });
+}
+
+void CThinkBatch::Clear()
+{
+	for (auto &handlers : m_handlers)
+		handlers.clear();
+
+	for (auto &thinking : m_thinking)
+		thinking = 0;
+}
+
+bool CThinkBatch::PassFilter(const handler_t &handler, size_t index) const
+{
+	CBasePlayer *pPlayer = UTIL_PlayerByIndex(index);
+	if (!pPlayer || pPlayer->has_disconnected)
+		return false;
+
+	if ((handler.filter & TBF_ALIVE) && !pPlayer->IsAlive())
+		return false;
+
+	if ((handler.filter & TBF_NOBOT) && (pPlayer->pev->flags & FL_FAKECLIENT))
+		return false;
+
+	if (handler.team != UNASSIGNED && pPlayer->m_iTeam != handler.team)
+		return false;
+
+	return true;
+}
+
+void CThinkBatch::Flush()
+{
+	for (int type = 0; type < BATCH_MAX; type++)
+	{
+		uint32 thinking = m_thinking[type];
+		m_thinking[type] = 0;
+
+		if (!thinking)
+			continue;
+
+		for (auto &handler : m_handlers[type])
+		{
+			// the handler could be disabled since the registration
+			auto fwd = g_hookManager.getAmxxHook(handler.handle);
+			if (!fwd || fwd->GetState() != FSTATE_ENABLED)
+				continue;
+
+			cell players[MAX_CLIENTS];
+			size_t count = 0;
+
+			for (size_t index = 1; index <= MAX_CLIENTS; index++)
+			{
+				if ((thinking & (1u << (index - 1))) && PassFilter(handler, index))
+					players[count++] = index;
+			}
+
+			if (!count)
+				continue;
+
+			if (unlikely(!fwd->CanExecDirect())) {
+				g_amxxapi.ExecuteForward(fwd->GetFwdIndex(), g_amxxapi.PrepareCellArrayA(players, count, false), count);
+				continue;
+			}
+
+			// AMX takes the parameters in reverse order
+			amxpush_t ctx(fwd->GetAmx());
+			amxPushCell(ctx, count);
+			amxPushArray(ctx, players, count);
+			ctx.exec(fwd);
+		}
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+// filter of players passed to the batch handler
+enum ThinkBatchFilter
+{
+	TBF_NONE  = 0,
+	TBF_ALIVE = BIT(0),   // only alive players
+	TBF_NOBOT = BIT(1),   // skip bots
+};
+
+// Batched handlers of CBasePlayer::PreThink/PostThink.
+// Players which have thought during the frame are collected and passed
+// to the handler once at the start of next frame.
+class CThinkBatch
+{
+public:
+	enum batch_e { BATCH_PRETHINK, BATCH_POSTTHINK, BATCH_MAX };
+
+	void Add(batch_e type, cell handle, int filter, TeamName team);
+	void Flush();
+	void Clear();
+
+	void Think(batch_e type, size_t index)
+	{
+		m_thinking[type] |= 1u << (index - 1);
+	}
+
+private:
+	struct handler_t
+	{
+		cell handle;
+		int filter;
+		TeamName team;
+	};
+
+	bool PassFilter(const handler_t &handler, size_t index) const;
+
+	std::vector<handler_t> m_handlers[BATCH_MAX];
+	uint32 m_thinking[BATCH_MAX] = {};
+};
+
+extern CThinkBatch g_thinkBatch;
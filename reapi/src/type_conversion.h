@@ -97,9 +97,18 @@ inline size_t indexOfPDataAmx(const T* pdata)
 	return index;
 }
 
-inline cell getAmxVector(Vector& vec)
+// vector argument of hookchain, it's copied to the AMX heap of each handler and copied back after the call
+struct amxvector_t
 {
-	return g_amxxapi.PrepareCellArrayA(reinterpret_cast<cell *>(&vec), 3, true);
+	constexpr amxvector_t() : vec(nullptr) {}
+	explicit constexpr amxvector_t(Vector &v) : vec(&v) {}
+
+	Vector *vec;
+};
+
+inline amxvector_t getAmxVector(Vector& vec)
+{
+	return amxvector_t(vec);
 }
 
 // HLTypeConversion.h -> AMXModX
@@ -145,21 +154,37 @@ inline T get_member_direct(edict_t *pEntity, int offset, int element = 0, int si
 	return get_member_direct<T>(pEntity->pvPrivateData, offset, element, size);
 }
 
+// Bump arena for the temp strings of hookchains.
+// Chunks are kept after release, so the arena grows up to the deepest nesting once and doesn't allocate after that.
 class CTempStrings
 {
 public:
 	CTempStrings();
-	char* push(struct tagAMX* amx);
-	void pop(size_t count);
+	~CTempStrings();
+
+	struct mark_t
+	{
+		size_t chunk;
+		size_t offset;
+	};
+
+	mark_t mark();
+	void release(const mark_t &m);
+	char* push(size_t size);
+
+	size_t GetPeakDepth() const { return m_peakDepth; }
+	size_t GetPeakBytes() const { return m_peakBytes; }
 
 	enum
 	{
-		STRINGS_MAX = 16,
+		CHUNK_SIZE = 16 * 1024,
 		STRING_SIZE = 1024,
 		STRING_LEN = STRING_SIZE - 1
 	};
 
 private:
-	size_t m_current;
-	char m_strings[STRINGS_MAX][STRING_SIZE];
+	std::vector<char *> m_chunks;
+	size_t m_chunk, m_offset;
+	size_t m_depth, m_peakDepth;
+	size_t m_peakBytes;
 };
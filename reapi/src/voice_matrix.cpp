@@ -0,0 +1,171 @@
+#include "precompiled.h"
+
+CVoiceMatrix g_voiceMatrix;
+
+void CVoiceMatrix::Apply(size_t listener, uint32 senders, VoiceListen listen)
+{
+	auto &decided = m_matrix.decided[listener - 1];
+	auto &hear = m_matrix.hear[listener - 1];
+
+	switch (listen)
+	{
+	case VL_DEFAULT:
+		decided &= ~senders;
+		hear &= ~senders;
+		break;
+	case VL_MUTE:
+		decided |= senders;
+		hear &= ~senders;
+		break;
+	case VL_HEAR:
+		decided |= senders;
+		hear |= senders;
+		break;
+	}
+}
+
+uint32 CVoiceMatrix::TeamMask(TeamName team) const
+{
+	uint32 mask = 0;
+
+	for (int index = 1; index <= gpGlobals->maxClients; index++)
+	{
+		CBasePlayer *pPlayer = UTIL_PlayerByIndex(index);
+		if (!pPlayer || pPlayer->has_disconnected)
+			continue;
+
+		if (team == UNASSIGNED || pPlayer->m_iTeam == team)
+			mask |= 1u << (index - 1);
+	}
+
+	return mask;
+}
+
+void CVoiceMatrix::Update()
+{
+	bool active = m_muteDead;
+
+	for (auto decided : m_matrix.decided)
+		active |= decided != 0;
+
+	if (active == m_active)
+		return;
+
+	m_active = active;
+
+	if (active)
+		g_hookManager.getHook(RG_CSGameRules_CanPlayerHearPlayer)->acquire();
+	else
+		g_hookManager.getHook(RG_CSGameRules_CanPlayerHearPlayer)->release();
+}
+
+void CVoiceMatrix::SetPair(size_t listener, size_t sender, VoiceListen listen)
+{
+	Apply(listener, 1u << (sender - 1), listen);
+	Update();
+}
+
+VoiceListen CVoiceMatrix::GetPair(size_t listener, size_t sender) const
+{
+	uint32 bit = 1u << (sender - 1);
+
+	if (!(m_matrix.decided[listener - 1] & bit))
+		return VL_DEFAULT;
+
+	return (m_matrix.hear[listener - 1] & bit) ? VL_HEAR : VL_MUTE;
+}
+
+void CVoiceMatrix::SetListener(size_t listener, VoiceListen listen)
+{
+	Apply(listener, UINT32_MAX, listen);
+	Update();
+}
+
+void CVoiceMatrix::SetSender(size_t sender, VoiceListen listen)
+{
+	for (size_t listener = 1; listener <= MAX_CLIENTS; listener++)
+		Apply(listener, 1u << (sender - 1), listen);
+
+	Update();
+}
+
+void CVoiceMatrix::SetTeams(TeamName listenerTeam, TeamName senderTeam, VoiceListen listen)
+{
+	uint32 listeners = TeamMask(listenerTeam);
+	uint32 senders = TeamMask(senderTeam);
+
+	for (size_t listener = 1; listeners; listener++, listeners >>= 1)
+	{
+		if (listeners & 1)
+			Apply(listener, senders, listen);
+	}
+
+	Update();
+}
+
+void CVoiceMatrix::MuteDead(bool mute)
+{
+	m_muteDead = mute;
+	Update();
+}
+
+void CVoiceMatrix::SavePreset(size_t preset)
+{
+	m_presets[preset] = m_matrix;
+}
+
+void CVoiceMatrix::LoadPreset(size_t preset)
+{
+	m_matrix = m_presets[preset];
+	Update();
+}
+
+void CVoiceMatrix::Reset()
+{
+	m_matrix = {};
+	m_muteDead = false;
+	Update();
+}
+
+void CVoiceMatrix::ResetPlayer(size_t index)
+{
+	uint32 bit = 1u << (index - 1);
+
+	m_matrix.decided[index - 1] = 0;
+	m_matrix.hear[index - 1] = 0;
+
+	for (size_t listener = 0; listener < MAX_CLIENTS; listener++) {
+		m_matrix.decided[listener] &= ~bit;
+		m_matrix.hear[listener] &= ~bit;
+	}
+
+	Update();
+}
+
+void CVoiceMatrix::Clear()
+{
+	for (auto &preset : m_presets)
+		preset = {};
+
+	Reset();
+}
+
+bool CVoiceMatrix::CanHear(CBasePlayer *pListener, CBasePlayer *pSender, bool &canHear) const
+{
+	if (!m_active)
+		return false;
+
+	if (m_muteDead && !pSender->IsAlive() && pListener->IsAlive()) {
+		canHear = false;
+		return true;
+	}
+
+	size_t listener = indexOfEdict(pListener->pev) - 1;
+	uint32 bit = 1u << (indexOfEdict(pSender->pev) - 1);
+
+	if (!(m_matrix.decided[listener] & bit))
+		return false;
+
+	canHear = (m_matrix.hear[listener] & bit) != 0;
+	return true;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#define MAX_VOICE_PRESETS 8
+
+enum VoiceListen
+{
+	VL_DEFAULT,   // decided by the game
+	VL_MUTE,      // listener doesn't hear sender
+	VL_HEAR,      // listener hears sender
+};
+
+// Listen matrix of the players, row is the listener and bit is the sender.
+// Consulted inside CSGameRules::CanPlayerHearPlayer hook, so the voice of
+// the decided pairs doesn't go through AMX unless a plugin hooks it.
+class CVoiceMatrix
+{
+public:
+	void SetPair(size_t listener, size_t sender, VoiceListen listen);
+	VoiceListen GetPair(size_t listener, size_t sender) const;
+	void SetListener(size_t listener, VoiceListen listen);
+	void SetSender(size_t sender, VoiceListen listen);
+	void SetTeams(TeamName listenerTeam, TeamName senderTeam, VoiceListen listen);
+	void MuteDead(bool mute);
+
+	void SavePreset(size_t preset);
+	void LoadPreset(size_t preset);
+
+	void Reset();
+	void ResetPlayer(size_t index);
+	void Clear();
+
+	// returns false if the pair isn't decided by the matrix
+	bool CanHear(CBasePlayer *pListener, CBasePlayer *pSender, bool &canHear) const;
+
+private:
+	struct matrix_t
+	{
+		uint32 decided[MAX_CLIENTS];  // senders decided by the matrix
+		uint32 hear[MAX_CLIENTS];     // senders heard by the listener
+	};
+
+	void Apply(size_t listener, uint32 senders, VoiceListen listen);
+	uint32 TeamMask(TeamName team) const;
+	void Update();
+
+	matrix_t m_matrix = {};
+	matrix_t m_presets[MAX_VOICE_PRESETS] = {};
+
+	bool m_muteDead = false;    // alive players don't hear dead ones
+	bool m_active = false;      // holds CanPlayerHearPlayer hookchain
+};
+
+extern CVoiceMatrix g_voiceMatrix;
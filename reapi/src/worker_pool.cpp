@@ -0,0 +1,153 @@
+#include "precompiled.h"
+
+CWorkerPool g_workerPool;
+CWorkerPool g_fileIOPool(1);    // the file operations keep their order
+
+void CWorkerPool::Start()
+{
+	size_t count = m_maxThreads;
+	if (!count)
+	{
+		// leave a core to the game thread
+		count = Sys_CpuCount();
+		count = clamp(count > 1 ? count - 1 : 1, size_t(1), size_t(4));
+	}
+
+	m_stop = false;
+	for (size_t i = 0; i < count; i++)
+	{
+		m_threads.emplace_back();
+
+		if (!m_threads.back().Start<CWorkerPool, &CWorkerPool::WorkerLoop>(this))
+			m_threads.pop_back();
+	}
+}
+
+void CWorkerPool::Submit(CWorkerTask *task)
+{
+	// the threads are started by the first task
+	if (m_threads.empty())
+		Start();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// the latest queued tasks first
+	for (auto iter = m_queue.rbegin(); iter != m_queue.rend(); iter++)
+	{
+		auto result = (*iter)->Merge(task);
+		if (result == CWorkerTask::MERGE_DONE) {
+			delete task;
+			return;
+		}
+
+		if (result == CWorkerTask::MERGE_BLOCKED)
+			break;
+	}
+
+	m_queue.push_back(task);
+	m_signal.notify_one();
+}
+
+void CWorkerPool::WorkerLoop()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	while (true)
+	{
+		m_signal.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+		if (m_queue.empty())
+			break;
+
+		CWorkerTask *task = m_queue.front();
+		m_queue.pop_front();
+		m_running.push_back(task);
+
+		lock.unlock();
+		task->Execute();
+		lock.lock();
+
+		m_running.erase(std::find(m_running.begin(), m_running.end(), task));
+
+		auto iter = std::find(m_cancelled.begin(), m_cancelled.end(), task);
+		if (iter != m_cancelled.end()) {
+			m_cancelled.erase(iter);
+			delete task;
+			continue;
+		}
+
+		m_completed.push_back(task);
+	}
+}
+
+void CWorkerPool::Dispatch()
+{
+	std::vector<CWorkerTask *> completed;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_completed.empty())
+			return;
+
+		completed.swap(m_completed);
+	}
+
+	for (auto task : completed)
+	{
+		task->Complete();
+		delete task;
+	}
+}
+
+void CWorkerPool::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::deque<CWorkerTask *> queue;
+	for (auto task : m_queue)
+	{
+		task->Cancel();
+
+		if (task->MustComplete())
+			queue.push_back(task);
+		else
+			delete task;
+	}
+
+	for (auto task : m_completed)
+	{
+		task->Cancel();
+		delete task;
+	}
+
+	// the running ones are deleted by their workers
+	for (auto task : m_running)
+	{
+		if (std::find(m_cancelled.begin(), m_cancelled.end(), task) == m_cancelled.end()) {
+			task->Cancel();
+			m_cancelled.push_back(task);
+		}
+	}
+
+	m_queue.swap(queue);
+	m_completed.clear();
+}
+
+void CWorkerPool::Shutdown()
+{
+	Clear();
+
+	// the workers stop when the queue is empty
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+		m_signal.notify_all();
+	}
+
+	for (auto &thread : m_threads)
+		thread.Join();
+
+	m_threads.clear();
+
+	// the tasks completed after the clear
+	Clear();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+// The work done off the game thread.
+// Execute is called on a worker thread and must not touch the engine, gamedll or AMX,
+// Complete is called on the game thread at the start of the frame after the execution.
+class CWorkerTask
+{
+public:
+	virtual ~CWorkerTask() {}
+
+	virtual void Execute() = 0;
+	virtual void Complete() = 0;
+
+	// the task is dropped, the results won't be delivered
+	virtual void Cancel() {}
+
+	// the task is executed even if dropped, like a write to a file
+	virtual bool MustComplete() const { return false; }
+
+	enum merge_e
+	{
+		MERGE_NONE,     // the tasks are independent
+		MERGE_DONE,     // the new task is merged into the queued one
+		MERGE_BLOCKED,  // the new task has to run after the queued one
+	};
+
+	// tries to merge the new task into this queued one
+	virtual merge_e Merge(CWorkerTask *task) { return MERGE_NONE; }
+};
+
+class CWorkerPool
+{
+public:
+	// the count of threads, 0 is by the count of cores
+	CWorkerPool(size_t threads = 0) : m_maxThreads(threads) {}
+
+	void Submit(CWorkerTask *task);
+	void Dispatch();    // delivers the completed tasks, game thread only
+	void Clear();       // drops all tasks, keeps the threads
+	void Shutdown();    // waits for the tasks which must complete
+
+private:
+	void Start();
+	void WorkerLoop();
+
+	std::list<CThread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_signal;
+
+	std::deque<CWorkerTask *> m_queue;      // waiting for a worker
+	std::vector<CWorkerTask *> m_running;   // executed right now
+	std::vector<CWorkerTask *> m_completed; // waiting for the next frame
+	std::vector<CWorkerTask *> m_cancelled; // running tasks dropped by Clear
+	size_t m_maxThreads;
+	bool m_stop = false;
+};
+
+extern CWorkerPool g_workerPool;
+extern CWorkerPool g_fileIOPool;
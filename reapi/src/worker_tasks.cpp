@@ -0,0 +1,403 @@
+#include "precompiled.h"
+
+#ifndef _WIN32
+#include <unistd.h>		// fsync
+#endif
+
+int CAmxWorkerTask::m_lastId = 0;
+const CReadFileTask *CReadFileTask::m_current = nullptr;
+
+CAmxWorkerTask::CAmxWorkerTask(AMX *amx, int fwdid, cell userdata) : m_amx(amx), m_id(++m_lastId), m_fwdid(fwdid), m_userdata(userdata)
+{
+}
+
+CAmxWorkerTask::~CAmxWorkerTask()
+{
+	if (m_fwdid != -1) {
+		g_amxxapi.UnregisterSPForward(m_fwdid);
+	}
+}
+
+bool CAmxWorkerTask::CheckHeap(size_t cells) const
+{
+	// the same limit as amx_Allot
+	if (size_t(m_amx->stk - m_amx->hea) >= cells * sizeof(cell) + STKMARGIN)
+		return true;
+
+	AMXX_LogError(m_amx, AMX_ERR_MEMORY, "Async task %d: the result of %u cells doesn't fit the heap of the plugin, raise it with #pragma dynamic", m_id, cells);
+	return false;
+}
+
+void CAmxWorkerTask::Cancel()
+{
+	// called on the game thread, the forward won't be valid after map change
+	if (m_fwdid != -1) {
+		g_amxxapi.UnregisterSPForward(m_fwdid);
+		m_fwdid = -1;
+	}
+}
+
+CSortTask::CSortTask(AMX *amx, int fwdid, cell userdata, const cell *data, size_t size, size_t blocksize, size_t keyoffset, AsyncSort type) :
+	CAmxWorkerTask(amx, fwdid, userdata), m_data(data, data + size), m_blocksize(blocksize), m_keyoffset(keyoffset), m_type(type)
+{
+}
+
+void CSortTask::Execute()
+{
+	size_t count = m_data.size() / m_blocksize;
+	std::vector<size_t> order(count);
+
+	for (size_t i = 0; i < count; i++)
+		order[i] = i;
+
+	const cell *keys = m_data.data() + m_keyoffset;
+	const size_t blocksize = m_blocksize;
+
+	auto key = [keys, blocksize](size_t record) { return keys[record * blocksize]; };
+	auto fkey = [keys, blocksize](size_t record) { return *(float *)&keys[record * blocksize]; };
+
+	switch (m_type)
+	{
+	case AS_INT_ASCENDING:
+		std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return key(a) < key(b); });
+		break;
+	case AS_INT_DESCENDING:
+		std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return key(a) > key(b); });
+		break;
+	case AS_FLOAT_ASCENDING:
+		std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return fkey(a) < fkey(b); });
+		break;
+	case AS_FLOAT_DESCENDING:
+		std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return fkey(a) > fkey(b); });
+		break;
+	}
+
+	// move the records in the sorted order
+	std::vector<cell> sorted(m_data.size());
+	for (size_t i = 0; i < count; i++)
+		Q_memcpy(&sorted[i * blocksize], &m_data[order[i] * blocksize], blocksize * sizeof(cell));
+
+	m_data.swap(sorted);
+}
+
+void CSortTask::Complete()
+{
+	cell size = m_data.size();
+	if (m_data.empty())
+		m_data.resize(1);
+
+	if (!CheckHeap(m_data.size()))
+		return;
+
+	g_amxxapi.ExecuteForward(m_fwdid, m_id, g_amxxapi.PrepareCellArrayA(m_data.data(), m_data.size(), false), size, m_userdata);
+}
+
+void CHashFilesTask::Execute()
+{
+	uint8 buf[16384];
+
+	for (auto &path : m_paths)
+	{
+		FILE *fp = fopen(path.c_str(), "rb");
+		if (!fp) {
+			m_hashes.push_back(0);
+			m_sizes.push_back(-1);
+			continue;
+		}
+
+		uint32 crc = 0;
+		size_t size = 0, len;
+
+		while ((len = fread(buf, 1, sizeof(buf), fp)) > 0) {
+			crc = Crc32(crc, buf, len);
+			size += len;
+		}
+
+		fclose(fp);
+		m_hashes.push_back(crc);
+		m_sizes.push_back(size);
+	}
+}
+
+void CHashFilesTask::Complete()
+{
+	cell count = m_hashes.size();
+	if (m_hashes.empty()) {
+		m_hashes.resize(1);
+		m_sizes.resize(1);
+	}
+
+	if (!CheckHeap(m_hashes.size() + m_sizes.size()))
+		return;
+
+	g_amxxapi.ExecuteForward(m_fwdid, m_id,
+		g_amxxapi.PrepareCellArrayA(m_hashes.data(), m_hashes.size(), false),
+		g_amxxapi.PrepareCellArrayA(m_sizes.data(), m_sizes.size(), false),
+		count, m_userdata);
+}
+
+void CParseConfigTask::AddString(const char *str, size_t len)
+{
+	m_offsets.push_back(m_buffer.size());
+	m_buffer.insert(m_buffer.end(), str, str + len);
+	m_buffer.push_back('\0');
+}
+
+// cuts the token off the line, the quotes are removed
+static const char *ParseToken(const char *&str, size_t &len)
+{
+	const char *token;
+
+	if (*str == '"') {
+		token = ++str;
+		while (*str && *str != '"')
+			str++;
+
+		len = str - token;
+		if (*str)
+			str++;
+
+		return token;
+	}
+
+	token = str;
+	while (*str && !isspace((unsigned char)*str) && *str != '=')
+		str++;
+
+	len = str - token;
+	return token;
+}
+
+void CParseConfigTask::Execute()
+{
+	FILE *fp = fopen(m_path.c_str(), "rt");
+	if (!fp)
+		return;
+
+	char line[1024];
+	m_count = 0;
+
+	while (fgets(line, sizeof(line), fp))
+	{
+		const char *str = line;
+		while (isspace((unsigned char)*str))
+			str++;
+
+		// empty line or comment
+		if (!*str || *str == ';' || *str == '#' || (str[0] == '/' && str[1] == '/'))
+			continue;
+
+		size_t len;
+		const char *key = ParseToken(str, len);
+		if (!len)
+			continue;
+
+		AddString(key, len);
+
+		while (isspace((unsigned char)*str) || *str == '=')
+			str++;
+
+		// the value is the rest of the line
+		const char *value = str;
+		if (*value == '"') {
+			value = ParseToken(str, len);
+		}
+		else {
+			len = strlen(value);
+			while (len > 0 && isspace((unsigned char)value[len - 1]))
+				len--;
+		}
+
+		AddString(value, len);
+		m_count++;
+	}
+
+	fclose(fp);
+}
+
+void CParseConfigTask::Complete()
+{
+	if (m_buffer.empty())
+		m_buffer.resize(1);
+
+	if (m_offsets.empty())
+		m_offsets.resize(1);
+
+	if (!CheckHeap(m_buffer.size() + m_offsets.size()))
+		return;
+
+	g_amxxapi.ExecuteForward(m_fwdid, m_id,
+		g_amxxapi.PrepareCellArrayA(m_buffer.data(), m_buffer.size(), false),
+		g_amxxapi.PrepareCellArrayA(m_offsets.data(), m_offsets.size(), false),
+		m_count, m_userdata);
+}
+
+CWorkerTask::merge_e CFileTask::Merge(CWorkerTask *task)
+{
+	auto other = dynamic_cast<CFileTask *>(task);
+	if (!other || other->m_path != m_path)
+		return MERGE_NONE;
+
+	// keep the order of the operations on the file
+	return MERGE_BLOCKED;
+}
+
+void CReadFileTask::Execute()
+{
+	FILE *fp = fopen(m_path.c_str(), "rb");
+	if (!fp)
+		return;
+
+	uint8 buf[16384];
+	size_t len;
+
+	while ((len = fread(buf, 1, sizeof(buf), fp)) > 0)
+		m_data.insert(m_data.end(), buf, buf + len);
+
+	fclose(fp);
+
+	m_length = m_data.size();
+}
+
+void CReadFileTask::Complete()
+{
+	if (m_fwdid == -1)
+		return;
+
+	// the content isn't passed as an array, a large file doesn't fit the heap of the plugin
+	auto previous = m_current;
+	m_current = this;
+	g_amxxapi.ExecuteForward(m_fwdid, m_id, m_length, m_userdata);
+	m_current = previous;
+}
+
+size_t CReadFileTask::Read(size_t offset, cell *buffer, size_t maxlen) const
+{
+	if (!maxlen)
+		return 0;
+
+	size_t count = 0;
+	if (offset < m_data.size())
+		count = min(m_data.size() - offset, maxlen - 1);
+
+	for (size_t i = 0; i < count; i++)
+		buffer[i] = (uint8)m_data[offset + i];
+
+	buffer[count] = '\0';
+	return count;
+}
+
+CAppendFileTask::~CAppendFileTask()
+{
+	for (auto &callback : m_merged)
+	{
+		if (callback.fwdid != -1)
+			g_amxxapi.UnregisterSPForward(callback.fwdid);
+	}
+}
+
+CWorkerTask::merge_e CAppendFileTask::Merge(CWorkerTask *task)
+{
+	auto other = dynamic_cast<CAppendFileTask *>(task);
+	if (!other || other->m_path != m_path)
+		return CFileTask::Merge(task);
+
+	m_text += other->m_text;
+	m_merged.push_back({ other->m_id, other->m_fwdid, other->m_userdata });
+
+	// the callback belongs to this task now
+	other->m_fwdid = -1;
+	return MERGE_DONE;
+}
+
+void CAppendFileTask::Execute()
+{
+	FILE *fp = fopen(m_path.c_str(), "ab");
+	if (!fp)
+		return;
+
+	m_success = fwrite(m_text.data(), 1, m_text.size(), fp) == m_text.size();
+	m_success = (fclose(fp) == 0) && m_success;
+}
+
+void CAppendFileTask::Complete()
+{
+	if (m_fwdid != -1)
+		g_amxxapi.ExecuteForward(m_fwdid, m_id, m_success, m_userdata);
+
+	for (auto &callback : m_merged)
+	{
+		if (callback.fwdid != -1)
+			g_amxxapi.ExecuteForward(callback.fwdid, callback.id, m_success, callback.userdata);
+	}
+}
+
+void CAppendFileTask::Cancel()
+{
+	CFileTask::Cancel();
+
+	for (auto &callback : m_merged)
+	{
+		if (callback.fwdid != -1) {
+			g_amxxapi.UnregisterSPForward(callback.fwdid);
+			callback.fwdid = -1;
+		}
+	}
+}
+
+void CWriteFileTask::Execute()
+{
+	std::string temp = m_path + ".tmp";
+
+	FILE *fp = fopen(temp.c_str(), "wb");
+	if (!fp)
+		return;
+
+	bool written = fwrite(m_text.data(), 1, m_text.size(), fp) == m_text.size() && fflush(fp) == 0;
+
+#ifndef _WIN32
+	// the data has to be on the disk before the rename
+	written = written && fsync(fileno(fp)) == 0;
+#endif
+
+	if (fclose(fp) != 0 || !written) {
+		remove(temp.c_str());
+		return;
+	}
+
+#ifdef _WIN32
+	// rename doesn't replace the existing file
+	remove(m_path.c_str());
+#endif
+
+	m_success = rename(temp.c_str(), m_path.c_str()) == 0;
+}
+
+void CWriteFileTask::Complete()
+{
+	if (m_fwdid != -1)
+		g_amxxapi.ExecuteForward(m_fwdid, m_id, m_success, m_userdata);
+}
+
+uint32 Crc32(uint32 crc, const uint8 *buf, size_t len)
+{
+	static uint32 table[256];
+	static std::once_flag initialized;
+
+	std::call_once(initialized, []() {
+		for (uint32 i = 0; i < 256; i++)
+		{
+			uint32 c = i;
+			for (int k = 0; k < 8; k++)
+				c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+
+			table[i] = c;
+		}
+	});
+
+	crc = ~crc;
+	while (len--)
+		crc = table[(crc ^ *buf++) & 0xFF] ^ (crc >> 8);
+
+	return ~crc;
+}
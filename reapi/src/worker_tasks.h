@@ -0,0 +1,161 @@
+#pragma once
+
+// key type and order of native AsyncSortArray
+enum AsyncSort
+{
+	AS_INT_ASCENDING,
+	AS_INT_DESCENDING,
+	AS_FLOAT_ASCENDING,
+	AS_FLOAT_DESCENDING,
+};
+
+// Worker task delivering the result to a forward of the plugin
+class CAmxWorkerTask: public CWorkerTask
+{
+public:
+	CAmxWorkerTask(AMX *amx, int fwdid, cell userdata);
+	~CAmxWorkerTask() override;
+
+	void Cancel() override;
+	int GetId() const { return m_id; }
+
+protected:
+	// the arrays of the forward are allocated on the heap of the plugin,
+	// AMX Mod X skips the call without an error if they don't fit
+	bool CheckHeap(size_t cells) const;
+
+	AMX *m_amx;
+	int m_id;
+	int m_fwdid;
+	cell m_userdata;
+
+private:
+	static int m_lastId;
+};
+
+// Sorts the records of a cell array by a key cell
+class CSortTask: public CAmxWorkerTask
+{
+public:
+	CSortTask(AMX *amx, int fwdid, cell userdata, const cell *data, size_t size, size_t blocksize, size_t keyoffset, AsyncSort type);
+
+	void Execute() override;
+	void Complete() override;
+
+private:
+	std::vector<cell> m_data;
+	size_t m_blocksize;
+	size_t m_keyoffset;
+	AsyncSort m_type;
+};
+
+// Computes CRC32 and size of the files
+class CHashFilesTask: public CAmxWorkerTask
+{
+public:
+	CHashFilesTask(AMX *amx, int fwdid, cell userdata) : CAmxWorkerTask(amx, fwdid, userdata) {}
+
+	void AddFile(const char *path) { m_paths.push_back(path); }
+
+	void Execute() override;
+	void Complete() override;
+
+private:
+	std::vector<std::string> m_paths;
+	std::vector<cell> m_hashes;
+	std::vector<cell> m_sizes;
+};
+
+// Parses a file of "key value" or "key = value" lines
+class CParseConfigTask: public CAmxWorkerTask
+{
+public:
+	CParseConfigTask(AMX *amx, int fwdid, cell userdata, const char *path) : CAmxWorkerTask(amx, fwdid, userdata), m_path(path), m_count(-1) {}
+
+	void Execute() override;
+	void Complete() override;
+
+private:
+	void AddString(const char *str, size_t len);
+
+	std::string m_path;
+	std::vector<cell> m_buffer;     // the strings of the keys and values
+	std::vector<cell> m_offsets;    // key and value offsets of each pair
+	int m_count;
+};
+
+// Operation on a file, the operations on the same file run in the order of adding
+class CFileTask: public CAmxWorkerTask
+{
+public:
+	CFileTask(AMX *amx, int fwdid, cell userdata, const char *path) : CAmxWorkerTask(amx, fwdid, userdata), m_path(path) {}
+
+	merge_e Merge(CWorkerTask *task) override;
+	bool MustComplete() const override { return true; }
+
+protected:
+	std::string m_path;
+};
+
+// Reads the whole file, the callback copies the content by chunks
+class CReadFileTask: public CFileTask
+{
+public:
+	CReadFileTask(AMX *amx, int fwdid, cell userdata, const char *path) : CFileTask(amx, fwdid, userdata, path), m_length(-1) {}
+
+	bool MustComplete() const override { return false; }
+	void Execute() override;
+	void Complete() override;
+
+	// the task of the running callback, nullptr outside of it
+	static const CReadFileTask *GetCurrent() { return m_current; }
+	size_t Read(size_t offset, cell *buffer, size_t maxlen) const;
+	int GetLength() const { return m_length; }
+
+private:
+	std::vector<char> m_data;
+	int m_length;
+
+	static const CReadFileTask *m_current;
+};
+
+// Appends the text to the file, the queued appends to the same file are written at once
+class CAppendFileTask: public CFileTask
+{
+public:
+	CAppendFileTask(AMX *amx, int fwdid, cell userdata, const char *path, std::string &&text) : CFileTask(amx, fwdid, userdata, path), m_text(std::move(text)), m_success(false) {}
+	~CAppendFileTask() override;
+
+	merge_e Merge(CWorkerTask *task) override;
+	void Execute() override;
+	void Complete() override;
+	void Cancel() override;
+
+private:
+	struct callback_t
+	{
+		int id;
+		int fwdid;
+		cell userdata;
+	};
+
+	std::string m_text;
+	std::vector<callback_t> m_merged;   // callbacks of the appends merged into the task
+	bool m_success;
+};
+
+// Replaces the file with the text through a temporary file
+class CWriteFileTask: public CFileTask
+{
+public:
+	CWriteFileTask(AMX *amx, int fwdid, cell userdata, const char *path, std::string &&text) : CFileTask(amx, fwdid, userdata, path), m_text(std::move(text)), m_success(false) {}
+
+	void Execute() override;
+	void Complete() override;
+
+private:
+	std::string m_text;
+	bool m_success;
+};
+
+uint32 Crc32(uint32 crc, const uint8 *buf, size_t len);